@@ -0,0 +1,88 @@
+#include "toml.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Throughput of toml_to_json() over a generated corpus.
+// usage: toml_json_bench [megabytes]   (default 64)
+// Both ends are stdio temp files, so a plain fread/fwrite copy of the same
+// input is timed too and the conversion rate is also given without it.
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long write_corpus(FILE *f, long target) {
+    long i = 0;
+    fprintf(f, "title = \"generated corpus\"\nversion = 1.0\n\n");
+    while (ftell(f) < target) {
+        fprintf(f,
+            "[service_%ld]\n"
+            "# generated entry\n"
+            "host = \"node-%ld.internal.example.com\"\n"
+            "port = %ld\n"
+            "weight = %ld.25\n"
+            "enabled = %s\n"
+            "started = 2025-10-07T08:%02ld:00Z\n"
+            "tags = [\"alpha\", \"beta\", \"gamma\"]\n"
+            "limits = { cpu = 4, mem = 8_192, burst = true }\n"
+            "note = \"\"\"\nline one\nline \\\"two\\\"\n\"\"\"\n\n"
+            "[[service_%ld.replica]]\nid = %ld\nzone = 'us-east-1a'\n\n"
+            "[[service_%ld.replica]]\nid = %ld\nzone = 'us-east-1b'\n\n",
+            i, i, 1000 + i % 60000, i % 100, (i & 1) ? "true" : "false",
+            i % 60, i, i * 2, i, i * 2 + 1);
+        i++;
+    }
+    return ftell(f);
+}
+
+// Best of three plain copies of in to out through 64 KiB buffers.
+static double time_copy(FILE *in, FILE *out) {
+    static char buf[64 * 1024];
+    double best = 0;
+    for (int run = 0; run < 3; run++) {
+        rewind(in);
+        rewind(out);
+        double t0 = now_sec();
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), in)) > 0) fwrite(buf, 1, n, out);
+        fflush(out);
+        double dt = now_sec() - t0;
+        if (run == 0 || dt < best) best = dt;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    long mb = argc > 1 ? atol(argv[1]) : 64;
+    FILE *in = tmpfile(), *out = tmpfile();
+    if (!in || !out) { fprintf(stderr, "cannot create temp files\n"); return 1; }
+
+    long size = write_corpus(in, mb * 1024 * 1024);
+    double best = 0;
+    for (int run = 0; run < 3; run++) {
+        rewind(in);
+        rewind(out);
+        TomlError err = {0};
+        double t0 = now_sec();
+        if (toml_to_json(in, out, &err) != 0) {
+            fprintf(stderr, "line %d: %s\n", err.line, err.message);
+            return 1;
+        }
+        fflush(out);
+        double dt = now_sec() - t0;
+        if (run == 0 || dt < best) best = dt;
+    }
+    double io = time_copy(in, out);
+    printf("toml_to_json: %.1f MB in %.3f s = %.1f MB/s\n",
+           size / 1048576.0, best, size / 1048576.0 / best);
+    if (best > io)
+        printf("stdio copy alone: %.3f s; conversion without it = %.1f MB/s\n",
+               io, size / 1048576.0 / (best - io));
+
+    fclose(in);
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include "toml.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Per-lookup cost of toml_get_int() versus ctoml::Table::get<int64_t>()
+// with a compile-time hashed key, on a table of 32 keys.
+// usage: toml_lookup_bench [iterations]   (default 20000000)
+
+using namespace ctoml::literals;
+
+static const char *bench_file = "lookup_bench.toml";
+
+template <class F>
+static double ns_per_call(long iters, F &&f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+}
+
+int main(int argc, char **argv) {
+    long iters = argc > 1 ? std::atol(argv[1]) : 20000000L;
+
+    FILE *f = std::fopen(bench_file, "w");
+    if (!f) { std::fprintf(stderr, "cannot write %s\n", bench_file); return 1; }
+    std::fprintf(f, "[server]\n");
+    for (int i = 0; i < 32; i++) std::fprintf(f, "setting_%02d = %d\n", i, i);
+    std::fclose(f);
+
+    ctoml::Doc doc = ctoml::Doc::load(bench_file);
+    std::remove(bench_file);
+    if (!doc) return 1;
+
+    ctoml::Table server = doc.root().table("server"_key);
+    const TomlTable *c_server = server.c_ptr();
+    volatile int64_t sink = 0;
+
+    double c_ns = ns_per_call(iters, [&] {
+        sink = sink + toml_get_int(c_server, "setting_24", 0);
+    });
+    double cpp_ns = ns_per_call(iters, [&] {
+        sink = sink + server.get<int64_t>("setting_24"_key, 0);
+    });
+    double path_ns = ns_per_call(iters, [&] {
+        sink = sink + doc.get<int64_t>("server.setting_24"_path, 0);
+    });
+
+    std::printf("toml_get_int            : %6.2f ns/lookup\n", c_ns);
+    std::printf("get<int64_t>(_key)      : %6.2f ns/lookup\n", cpp_ns);
+    std::printf("get<int64_t>(_path)     : %6.2f ns/lookup\n", path_ns);
+    return sink == 0; // keep the loops alive
+}
@@ -2,6 +2,13 @@
 #define TOML_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #define MAX_KEY_LEN       128
 #define MAX_VAL_LEN       256
@@ -32,16 +39,17 @@ typedef struct TomlTable TomlTable;
 // ---------- Entries and Tables ----------
 struct TomlEntry {
     char key[MAX_KEY_LEN];
+    uint32_t key_hash; // toml_hash_key(key)
     TomlValueType type;
     char comment[128];
     union {
         char str_val[MAX_VAL_LEN];
-        int int_val;
+        int64_t int_val;
         double float_val;
         bool bool_val;
         TomlDatetime datetime;
         struct {
-            int ints[MAX_ARRAY_ITEMS];
+            int64_t ints[MAX_ARRAY_ITEMS];
             double floats[MAX_ARRAY_ITEMS];
             char strings[MAX_ARRAY_ITEMS][MAX_VAL_LEN];
             int length;
@@ -49,10 +57,13 @@ struct TomlEntry {
         TomlTable *table_val; // for inline tables
     } value;
     int line_num;
+    size_t src_off, src_len; // byte span of the value text in TomlDoc.src
+    bool dirty;              // changed by a toml_set_* call
 };
 
 struct TomlTable {
     char name[MAX_KEY_LEN];
+    uint32_t name_hash; // toml_hash_key(name)
     TomlEntry *entries;
     int entry_count, entry_cap;
 
@@ -79,18 +90,26 @@ typedef struct {
 typedef struct {
     TomlTable *root;
     TomlErrorList errs;
+    char *src;      // original file contents, kept for toml_patch_write()
+    size_t src_len;
 } TomlDoc;
 
 // ---------- Access API ----------
 TomlDoc *toml_load(const char *filename);
 void toml_free(TomlDoc *doc);
 
+// 32-bit FNV-1a of a key; stored on every entry and table so lookups can
+// compare hashes first. toml.hpp computes the same hash at compile time.
+uint32_t toml_hash_key(const char *key);
+
 // Table & Entry access
 TomlTable *toml_table_get(TomlTable *parent, const char *name);
 const TomlEntry *toml_entry_get(const TomlTable *tbl, const char *key);
 
 // Typed accessors
+// toml_get_int returns def when the value does not fit in an int.
 int toml_get_int(const TomlTable *t, const char *key, int def);
+int64_t toml_get_int64(const TomlTable *t, const char *key, int64_t def);
 double toml_get_float(const TomlTable *t, const char *key, double def);
 bool toml_get_bool(const TomlTable *t, const char *key, bool def);
 const char *toml_get_string(const TomlTable *t, const char *key, const char *def);
@@ -106,6 +125,34 @@ typedef struct {
 int toml_write(const TomlDoc *doc, const char *filename,
                const TomlWriteOptions *opts);
 
+// ---------- Edit API ----------
+// Setters replace the value of an existing key and mark it dirty.
+// They return 0 on success, -1 if the key does not exist. toml_set_string
+// also returns -1, leaving the entry untouched, if val is MAX_VAL_LEN bytes
+// or longer.
+int toml_set_int(TomlTable *t, const char *key, int val);
+int toml_set_int64(TomlTable *t, const char *key, int64_t val);
+int toml_set_float(TomlTable *t, const char *key, double val);
+int toml_set_bool(TomlTable *t, const char *key, bool val);
+int toml_set_string(TomlTable *t, const char *key, const char *val);
+
+// Writes the original source with only the dirty value spans re-rendered;
+// every other byte (comments, spacing, key order) is copied through as-is.
+// Returns -1 without writing if an edited value has no reliable span
+// (unterminated multiline string, line longer than the parse buffer).
+int toml_patch_write(const TomlDoc *doc, const char *filename);
+
+// ---------- JSON API ----------
+// Converts TOML read from `in` straight to compact JSON on `out` without
+// building a TomlDoc; memory use is constant in the document size.
+// Datetimes are written as RFC 3339 strings. Returns 0 on success, or -1
+// with the failing line and reason in *err (which may be NULL).
+// Limitation: only the currently open table path is remembered, so a table
+// or dotted-key prefix that is reopened after something else (e.g.
+// `a.b = 1` / `c = 2` / `a.d = 3`) is emitted twice as a duplicate JSON
+// key, and most JSON readers keep only the last copy.
+int toml_to_json(FILE *in, FILE *out, TomlError *err);
+
 // ---------- Validation API ----------
 typedef enum {
     TOML_OK,
@@ -118,4 +165,8 @@ TomlValidationCode toml_expect_type(const TomlTable *t, const char *key,
 TomlValidationCode toml_require(const TomlTable *t, const char *key,
                                 TomlValueType type);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,341 @@
+#ifndef TOML_HPP
+#define TOML_HPP
+
+// Header-only C++17 layer over the C API. Keys written as "name"_key or
+// "a.b.c"_path are hashed at compile time, so a lookup is an integer
+// compare per entry with a string compare only on a hash match. Values
+// are returned as views into the TomlDoc; nothing is copied.
+// std::span accessors are available when compiled as C++20.
+
+#include "toml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define CTOML_HAS_SPAN 1
+#else
+#define CTOML_HAS_SPAN 0
+#endif
+
+// Literals are consteval where available so hashing can never slip to runtime.
+#if defined(__cpp_consteval)
+#define CTOML_CONSTEVAL consteval
+#else
+#define CTOML_CONSTEVAL constexpr
+#endif
+
+namespace ctoml {
+
+// ---------- Compile-time keys ----------
+// Must stay in sync with toml_hash_key() in toml.c.
+constexpr uint32_t hash_key(std::string_view s) noexcept {
+    uint32_t h = 2166136261u;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static_assert(hash_key("") == 2166136261u && hash_key("a") == 0xe40c292cu,
+              "hash_key must match toml_hash_key");
+
+struct Key {
+    std::string_view name;
+    uint32_t hash;
+
+    constexpr Key() noexcept : Key(std::string_view()) {}
+    constexpr Key(std::string_view n) noexcept : name(n), hash(hash_key(n)) {}
+    constexpr Key(const char *n) noexcept : Key(std::string_view(n)) {}
+
+    bool matches(const char *stored, uint32_t stored_hash) const noexcept {
+        return stored_hash == hash &&
+               std::strncmp(stored, name.data(), name.size()) == 0 &&
+               stored[name.size()] == '\0';
+    }
+};
+
+namespace detail {
+// Deliberately not constexpr: reaching it while a _path literal is being
+// evaluated at compile time makes the literal ill-formed.
+inline void path_has_too_many_segments() noexcept {}
+} // namespace detail
+
+// A dotted path split and hashed up front: all but the last segment name
+// tables, the last names the entry. A path with more than max_segments
+// segments is a compile error as a literal and matches nothing at run time.
+struct Path {
+    static constexpr int max_segments = 8;
+    Key segs[max_segments]{};
+    int count = 0;
+
+    constexpr Path(std::string_view p) noexcept {
+        std::size_t start = 0;
+        for (std::size_t i = 0; i <= p.size(); i++) {
+            if (i != p.size() && p[i] != '.') continue;
+            if (count == max_segments) {
+                detail::path_has_too_many_segments();
+                count = 0;
+                return;
+            }
+            segs[count++] = Key(p.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+};
+
+namespace literals {
+CTOML_CONSTEVAL Key operator""_key(const char *s, std::size_t n) noexcept {
+    return Key(std::string_view(s, n));
+}
+CTOML_CONSTEVAL Path operator""_path(const char *s, std::size_t n) noexcept {
+    return Path(std::string_view(s, n));
+}
+} // namespace literals
+
+class Table;
+
+template <class T>
+inline constexpr bool dependent_false = false;
+
+// Whether a stored 64-bit TOML integer is representable as T.
+template <class T>
+constexpr bool int_fits(int64_t v) noexcept {
+    if constexpr (std::is_signed_v<T>)
+        return v >= static_cast<int64_t>(std::numeric_limits<T>::min()) &&
+               v <= static_cast<int64_t>(std::numeric_limits<T>::max());
+    else
+        return v >= 0 && static_cast<uint64_t>(v) <= std::numeric_limits<T>::max();
+}
+
+// ---------- Entry ----------
+class Entry {
+public:
+    constexpr Entry() noexcept = default;
+    constexpr explicit Entry(const TomlEntry *e) noexcept : e_(e) {}
+
+    explicit operator bool() const noexcept { return e_ != nullptr; }
+    const TomlEntry *c_ptr() const noexcept { return e_; }
+
+    std::string_view key() const noexcept { return e_->key; }
+    TomlValueType type() const noexcept { return e_->type; }
+    int line() const noexcept { return e_->line_num; }
+
+    // Typed value, or nullopt when the entry is missing or of another type.
+    template <class T>
+    std::optional<T> as() const noexcept;
+
+private:
+    const TomlEntry *e_ = nullptr;
+};
+
+// ---------- Table ----------
+// Non-owning view of a TomlTable; stays valid as long as its Doc does.
+class Table {
+public:
+    constexpr Table() noexcept = default;
+    constexpr explicit Table(const TomlTable *t) noexcept : t_(t) {}
+
+    explicit operator bool() const noexcept { return t_ != nullptr; }
+    const TomlTable *c_ptr() const noexcept { return t_; }
+    std::string_view name() const noexcept { return t_->name; }
+    bool is_array() const noexcept { return t_ && t_->is_array; }
+
+    // On a [[name]] container, lookups go to its latest element, the same
+    // way [name.sub] headers resolve in the parser.
+    Entry find(Key k) const noexcept {
+        const TomlTable *t = scope();
+        if (!t) return Entry();
+        for (int i = 0; i < t->entry_count; i++)
+            if (k.matches(t->entries[i].key, t->entries[i].key_hash))
+                return Entry(&t->entries[i]);
+        return Entry();
+    }
+
+    Table table(Key k) const noexcept {
+        const TomlTable *t = scope();
+        if (!t) return Table();
+        for (int i = 0; i < t->sub_count; i++)
+            if (k.matches(t->subtables[i]->name, t->subtables[i]->name_hash))
+                return Table(t->subtables[i]);
+        return Table();
+    }
+
+    // Follows every segment of the path as a table name.
+    Table table(const Path &p) const noexcept {
+        if (p.count == 0) return Table();
+        Table cur = *this;
+        for (int i = 0; i < p.count && cur; i++) cur = cur.table(p.segs[i]);
+        return cur;
+    }
+
+    Entry find(const Path &p) const noexcept {
+        if (p.count == 0) return Entry();
+        Table cur = *this;
+        for (int i = 0; i < p.count - 1 && cur; i++) cur = cur.table(p.segs[i]);
+        return cur.find(p.segs[p.count - 1]);
+    }
+
+    template <class T>
+    std::optional<T> get(Key k) const noexcept { return find(k).template as<T>(); }
+    template <class T>
+    std::optional<T> get(const Path &p) const noexcept { return find(p).template as<T>(); }
+
+    template <class T>
+    T get(Key k, T def) const noexcept { return get<T>(k).value_or(def); }
+    template <class T>
+    T get(const Path &p, T def) const noexcept { return get<T>(p).value_or(def); }
+
+    // ----- iteration -----
+    // Items are views built on dereference, so these are input iterators.
+    template <class Item, class Source>
+    class Range {
+    public:
+        class iterator {
+        public:
+            using value_type = Item;
+            using difference_type = std::ptrdiff_t;
+            using reference = Item;
+            using pointer = void;
+            using iterator_category = std::input_iterator_tag;
+
+            iterator(Source s, int i) noexcept : s_(s), i_(i) {}
+            Item operator*() const noexcept { return Range::at(s_, i_); }
+            iterator &operator++() noexcept { ++i_; return *this; }
+            iterator operator++(int) noexcept { iterator r = *this; ++i_; return r; }
+            bool operator==(const iterator &o) const noexcept { return i_ == o.i_; }
+            bool operator!=(const iterator &o) const noexcept { return i_ != o.i_; }
+
+        private:
+            Source s_;
+            int i_;
+        };
+
+        Range(Source s, int n) noexcept : s_(s), n_(n) {}
+        iterator begin() const noexcept { return iterator(s_, 0); }
+        iterator end() const noexcept { return iterator(s_, n_); }
+        int size() const noexcept { return n_; }
+        bool empty() const noexcept { return n_ == 0; }
+        Item operator[](int i) const noexcept { return at(s_, i); }
+
+    private:
+        static Item at(Source s, int i) noexcept {
+            if constexpr (std::is_same_v<Item, Entry>) return Entry(&s[i]);
+            else return Table(s[i]);
+        }
+        Source s_;
+        int n_;
+    };
+
+    using EntryRange = Range<Entry, const TomlEntry *>;
+    using TableRange = Range<Table, TomlTable *const *>;
+
+    EntryRange entries() const noexcept {
+        return t_ ? EntryRange(t_->entries, t_->entry_count) : EntryRange(nullptr, 0);
+    }
+    TableRange subtables() const noexcept {
+        return t_ ? TableRange(t_->subtables, t_->sub_count) : TableRange(nullptr, 0);
+    }
+    // Element tables of a [[name]] array; empty for ordinary tables.
+    TableRange elements() const noexcept {
+        return t_ ? TableRange(t_->table_array, t_->arr_count) : TableRange(nullptr, 0);
+    }
+
+    EntryRange::iterator begin() const noexcept { return entries().begin(); }
+    EntryRange::iterator end() const noexcept { return entries().end(); }
+
+private:
+    const TomlTable *scope() const noexcept {
+        return (t_ && t_->is_array && t_->arr_count) ? t_->table_array[t_->arr_count - 1] : t_;
+    }
+
+    const TomlTable *t_ = nullptr;
+};
+
+template <class T>
+std::optional<T> Entry::as() const noexcept {
+    if (!e_) return std::nullopt;
+    const auto &v = e_->value;
+    if constexpr (std::is_same_v<T, bool>) {
+        if (e_->type == TOML_BOOL) return v.bool_val;
+    } else if constexpr (std::is_integral_v<T>) {
+        // out-of-range values are a miss, never a silent truncation
+        if (e_->type == TOML_INT && int_fits<T>(v.int_val)) return static_cast<T>(v.int_val);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        if (e_->type == TOML_FLOAT) return static_cast<T>(v.float_val);
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        if (e_->type == TOML_STRING) return std::string_view(v.str_val);
+    } else if constexpr (std::is_same_v<T, const char *>) {
+        if (e_->type == TOML_STRING) return v.str_val;
+    } else if constexpr (std::is_same_v<T, TomlDatetime>) {
+        if (e_->type == TOML_DATETIME) return v.datetime;
+    } else if constexpr (std::is_same_v<T, Table>) {
+        if (e_->type == TOML_TABLE) return Table(v.table_val);
+#if CTOML_HAS_SPAN
+    } else if constexpr (std::is_same_v<T, std::span<const int64_t>>) {
+        if (e_->type == TOML_ARRAY_INT)
+            return std::span<const int64_t>(v.array.ints, static_cast<std::size_t>(v.array.length));
+    } else if constexpr (std::is_same_v<T, std::span<const double>>) {
+        if (e_->type == TOML_ARRAY_FLOAT)
+            return std::span<const double>(v.array.floats, static_cast<std::size_t>(v.array.length));
+#endif
+    } else {
+        static_assert(dependent_false<T>, "unsupported type for ctoml::Entry::as<T>()");
+    }
+    return std::nullopt;
+}
+
+// ---------- Doc ----------
+// Owns a TomlDoc and frees it with toml_free(); move-only.
+class Doc {
+public:
+    Doc() noexcept = default;
+    explicit Doc(TomlDoc *d) noexcept : d_(d) {}
+    ~Doc() { toml_free(d_); }
+
+    Doc(Doc &&o) noexcept : d_(std::exchange(o.d_, nullptr)) {}
+    Doc &operator=(Doc &&o) noexcept {
+        if (this != &o) {
+            toml_free(d_);
+            d_ = std::exchange(o.d_, nullptr);
+        }
+        return *this;
+    }
+    Doc(const Doc &) = delete;
+    Doc &operator=(const Doc &) = delete;
+
+    // Empty Doc (false in a boolean context) when the file cannot be opened.
+    static Doc load(const char *filename) noexcept { return Doc(toml_load(filename)); }
+
+    explicit operator bool() const noexcept { return d_ != nullptr; }
+    TomlDoc *c_ptr() const noexcept { return d_; }
+    TomlDoc *release() noexcept { return std::exchange(d_, nullptr); }
+
+    Table root() const noexcept { return Table(d_ ? d_->root : nullptr); }
+    const TomlErrorList *errors() const noexcept { return d_ ? &d_->errs : nullptr; }
+
+    template <class T>
+    std::optional<T> get(Key k) const noexcept { return root().get<T>(k); }
+    template <class T>
+    std::optional<T> get(const Path &p) const noexcept { return root().get<T>(p); }
+    template <class T>
+    T get(Key k, T def) const noexcept { return root().get<T>(k, def); }
+    template <class T>
+    T get(const Path &p, T def) const noexcept { return root().get<T>(p, def); }
+
+private:
+    TomlDoc *d_ = nullptr;
+};
+
+} // namespace ctoml
+
+#endif
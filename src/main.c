@@ -69,7 +69,7 @@ int main(void) {
             printf("  %s = ", t->entries[i].key),
             (t->entries[i].type == TOML_STRING)
                 ? printf("\"%s\"\n", t->entries[i].value.str_val)
-                : printf("%d\n", t->entries[i].value.int_val);
+                : printf("%lld\n", (long long)t->entries[i].value.int_val);
     }
 
     // --- dotted keys (database.main.*) ---
@@ -92,6 +92,21 @@ int main(void) {
     if (toml_write(doc, "output.toml", &opts) == 0)
         printf("\nConfig re‑written successfully to output.toml\n");
 
+    // --- in-place patch test ---
+    TomlTable *srv = toml_table_get(doc->root, "server");
+    if (srv) {
+        toml_set_int(srv, "port", 9090);
+        TomlTable *srv_cfg = toml_table_get(srv, "config");
+        if (srv_cfg)
+            toml_set_string(srv_cfg, "compression", "zstd");
+        const TomlEntry *srv_details = toml_entry_get(srv, "details");
+        if (srv_details && srv_details->type == TOML_TABLE)
+            toml_set_int(srv_details->value.table_val, "cores", 16);
+    }
+    toml_set_float(doc->root, "version", 1.3);
+    if (toml_patch_write(doc, "patched.toml") == 0)
+        printf("Config patched in place to patched.toml\n");
+
     // --- validations ---
     toml_require(server, "host", TOML_STRING);
     toml_require(server, "port", TOML_INT);
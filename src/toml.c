@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <inttypes.h>
+#include <limits.h>
 
 // ------------------------------------------------------------
 // Utility helpers
@@ -17,10 +19,61 @@ static void trim(char *s) {
     *(end + 1) = '\0';
 }
 
+static size_t leading_space(const char *s) {
+    size_t n = 0;
+    while (isspace((unsigned char)s[n])) n++;
+    return n;
+}
+
+// fgets() over the in-memory source: copies the next line into buf
+// (truncated to cap - 1 bytes) and advances *pos past it.
+static bool next_line(const char *src, size_t len, size_t *pos,
+                      char *buf, size_t cap) {
+    if (*pos >= len) return false;
+    const char *start = src + *pos;
+    const char *nl = memchr(start, '\n', len - *pos);
+    size_t n = nl ? (size_t)(nl - start) + 1 : len - *pos;
+    size_t copy = n < cap - 1 ? n : cap - 1;
+    memcpy(buf, start, copy);
+    buf[copy] = '\0';
+    *pos += n;
+    return true;
+}
+
+// First '#' outside "..." and '...' strings, or NULL. *open is set when
+// the line ends inside a string, i.e. the quotes do not balance.
+static char *find_comment(char *s, bool *open) {
+    char quote = 0;
+    for (; *s; s++) {
+        if (quote) {
+            if (*s == '\\' && quote == '"' && s[1]) s++;
+            else if (*s == quote) quote = 0;
+        } else if (*s == '"' || *s == '\'') {
+            quote = *s;
+        } else if (*s == '#') {
+            *open = false;
+            return s;
+        }
+    }
+    *open = quote != 0;
+    return NULL;
+}
+
 static bool starts_with(const char *s, const char *prefix) {
     return strncmp(s, prefix, strlen(prefix)) == 0;
 }
 
+static void free_table(TomlTable *t);
+
+uint32_t toml_hash_key(const char *key) {
+    uint32_t h = 2166136261u;
+    for (; *key; key++) {
+        h ^= (unsigned char)*key;
+        h *= 16777619u;
+    }
+    return h;
+}
+
 static void err_add(TomlErrorList *elist, int line, const char *msg) {
     if (elist->count >= elist->cap) {
         elist->cap = elist->cap ? elist->cap * 2 : 8;
@@ -43,6 +96,7 @@ static TomlEntry *entry_add(TomlTable *t, const char *key) {
     TomlEntry *e = &t->entries[t->entry_count++];
     memset(e, 0, sizeof(TomlEntry));
     strncpy(e->key, key, MAX_KEY_LEN - 1);
+    e->key_hash = toml_hash_key(e->key);
     return e;
 }
 
@@ -56,10 +110,24 @@ static TomlTable *subtable_add(TomlTable *p, const char *name) {
     }
     TomlTable *t = calloc(1, sizeof(TomlTable));
     strncpy(t->name, name, MAX_KEY_LEN - 1);
+    t->name_hash = toml_hash_key(t->name);
     p->subtables[p->sub_count++] = t;
     return t;
 }
 
+// Appends a new element table for a [[name]] header.
+static TomlTable *table_array_add(TomlTable *p) {
+    if (p->arr_count >= p->arr_cap) {
+        p->arr_cap = p->arr_cap ? p->arr_cap * 2 : 4;
+        p->table_array = realloc(p->table_array, p->arr_cap * sizeof(TomlTable *));
+    }
+    TomlTable *t = calloc(1, sizeof(TomlTable));
+    memcpy(t->name, p->name, sizeof(t->name));
+    t->name_hash = p->name_hash;
+    p->table_array[p->arr_count++] = t;
+    return t;
+}
+
 static TomlTable *ensure_path(TomlTable *root, const char *path) {
     if (!path || !*path) return root;
     char buf[256];
@@ -70,10 +138,18 @@ static TomlTable *ensure_path(TomlTable *root, const char *path) {
     while (tok) {
         cur = subtable_add(cur, tok);
         tok = strtok(NULL, ".");
+        // [a.b] after [[a]] belongs to the latest element of a
+        if (tok && cur->is_array && cur->arr_count)
+            cur = cur->table_array[cur->arr_count - 1];
     }
     return cur;
 }
 
+// Lookups through an array-of-tables container go to its latest element.
+static TomlTable *array_scope(TomlTable *t) {
+    return (t->is_array && t->arr_count) ? t->table_array[t->arr_count - 1] : t;
+}
+
 // ------------------------------------------------------------
 // Datetime Parsing
 // ------------------------------------------------------------
@@ -98,7 +174,7 @@ static bool parse_datetime(const char *src, TomlDatetime *out) {
 // ------------------------------------------------------------
 // Inline Table Parsing
 // ------------------------------------------------------------
-static TomlTable *parse_inline_table(const char *src) {
+static TomlTable *parse_inline_table(const char *src, size_t src_off) {
     TomlTable *tbl = calloc(1, sizeof(TomlTable));
     if (!tbl) return NULL;
 
@@ -106,6 +182,7 @@ static TomlTable *parse_inline_table(const char *src) {
     char buf[512];
     strncpy(buf, src, sizeof(buf) - 1);
     buf[sizeof(buf) - 1] = '\0';
+    src_off += leading_space(buf);
     trim(buf);
 
     // Tokenize by comma
@@ -127,12 +204,15 @@ static TomlTable *parse_inline_table(const char *src) {
         char val_buf[MAX_VAL_LEN];
         strncpy(val_buf, eq + 1, sizeof(val_buf) - 1);
         val_buf[sizeof(val_buf) - 1] = '\0';
+        size_t val_off = src_off + (size_t)(eq + 1 - buf) + leading_space(val_buf);
         trim(val_buf);
 
         // pointer version so we can increment safely
         char *val = val_buf;
 
         TomlEntry *e = entry_add(tbl, key);
+        e->src_off = val_off;
+        e->src_len = strlen(val);
 
         // String value
         if (*val == '"' && val[strlen(val) - 1] == '"') {
@@ -155,7 +235,7 @@ static TomlTable *parse_inline_table(const char *src) {
         // Integer (fallback)
         } else {
             e->type = TOML_INT;
-            e->value.int_val = atoi(val);
+            e->value.int_val = strtoll(val, NULL, 10);
         }
 
         token = strtok(NULL, ",");
@@ -174,43 +254,72 @@ static TomlValueType parse_array(const char *src, TomlEntry *e) {
     trim(buf);
     e->value.array.length = 0;
     if (!strlen(buf)) return TOML_ARRAY_INT;
+    // Classify every item first, then store each one at its own index in
+    // the array of the widest type seen, so [1, 2.5, 3] is three floats.
+    char *items[MAX_ARRAY_ITEMS];
+    int n = 0, floats = 0, strs = 0;
     char *tok = strtok(buf, ",");
-    int ints = 0, floats = 0, strs = 0;
-    while (tok && e->value.array.length < MAX_ARRAY_ITEMS) {
+    while (tok && n < MAX_ARRAY_ITEMS) {
         trim(tok);
         if (*tok == '"' && tok[strlen(tok) - 1] == '"') {
             tok[strlen(tok)-1] = '\0'; tok++;
-            strncpy(e->value.array.strings[strs++], tok, MAX_VAL_LEN - 1);
+            strs++;
         } else if (strchr(tok, '.')) {
-            e->value.array.floats[floats++] = atof(tok);
-        } else {
-            e->value.array.ints[ints++] = atoi(tok);
+            floats++;
         }
-        e->value.array.length++;
+        items[n++] = tok;
         tok = strtok(NULL, ",");
     }
-    if (strs) return TOML_ARRAY_STRING;
-    if (floats) return TOML_ARRAY_FLOAT;
-    return TOML_ARRAY_INT;
+    TomlValueType type = strs ? TOML_ARRAY_STRING
+                       : floats ? TOML_ARRAY_FLOAT : TOML_ARRAY_INT;
+    for (int i = 0; i < n; i++) {
+        if (type == TOML_ARRAY_STRING) {
+            strncpy(e->value.array.strings[i], items[i], MAX_VAL_LEN - 1);
+            e->value.array.strings[i][MAX_VAL_LEN - 1] = '\0';
+        } else if (type == TOML_ARRAY_FLOAT) {
+            e->value.array.floats[i] = atof(items[i]);
+        } else {
+            e->value.array.ints[i] = strtoll(items[i], NULL, 10);
+        }
+    }
+    e->value.array.length = n;
+    return type;
 }
 
 // ------------------------------------------------------------
 // Parser Core
 // ------------------------------------------------------------
 TomlDoc *toml_load(const char *filename) {
-    FILE *f = fopen(filename, "r");
+    FILE *f = fopen(filename, "rb");
     if (!f) { fprintf(stderr, "cannot open %s\n", filename); return NULL; }
 
+    // Keep the raw bytes around so entries can point back into them
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) { fclose(f); return NULL; }
+    char *src = malloc((size_t)size + 1);
+    size_t src_len = fread(src, 1, (size_t)size, f);
+    src[src_len] = '\0';
+    fclose(f);
+
     TomlDoc *doc = calloc(1, sizeof(TomlDoc));
+    doc->src = src;
+    doc->src_len = src_len;
     doc->root = calloc(1, sizeof(TomlTable));
     strncpy(doc->root->name, "root", sizeof(doc->root->name)-1);
+    doc->root->name_hash = toml_hash_key(doc->root->name);
 
     char line[1024], current_path[128] = "";
     TomlTable *current = doc->root;
     int line_no = 0;
+    size_t pos = 0, line_off = 0;
 
-    while (fgets(line, sizeof(line), f)) {
+    while (line_off = pos, next_line(src, src_len, &pos, line, sizeof(line))) {
         line_no++;
+        // spans on a line longer than the buffer cannot be trusted
+        bool truncated = strlen(line) < pos - line_off;
+        line_off += leading_space(line);
         trim(line);
         if (!*line) continue;
 
@@ -226,8 +335,9 @@ TomlDoc *toml_load(const char *filename) {
             strncpy(name, line + 2, strlen(line) - 4);
             name[strlen(line)-4] = '\0';
             trim(name);
-            current = ensure_path(doc->root, name);
-            current->is_array = true;
+            TomlTable *arr = ensure_path(doc->root, name);
+            arr->is_array = true;
+            current = table_array_add(arr);
             continue;
         } else if (line[0] == '[' && line[strlen(line)-1] == ']') {
             strncpy(current_path, line+1, strlen(line)-2);
@@ -238,7 +348,8 @@ TomlDoc *toml_load(const char *filename) {
         }
 
         // key/value with potential comment
-        char *hash = strchr(line, '#');
+        bool open_quote;
+        char *hash = find_comment(line, &open_quote);
         char comment[128] = "";
         if (hash) {
             strncpy(comment, hash + 1, sizeof(comment) - 1);
@@ -249,7 +360,9 @@ TomlDoc *toml_load(const char *filename) {
         if (!eq) { err_add(&doc->errs, line_no, "missing '='"); continue; }
         *eq = '\0';
         char keybuf[128]; strncpy(keybuf, line, sizeof(keybuf)-1); trim(keybuf);
-        char *val = eq + 1; trim(val);
+        char *val = eq + 1;
+        size_t val_off = line_off + (size_t)(val - line) + leading_space(val);
+        trim(val);
 
         // dotted keys
         char keycopy[128]; strncpy(keycopy, keybuf, sizeof(keycopy)-1);
@@ -261,16 +374,39 @@ TomlDoc *toml_load(const char *filename) {
 
         TomlEntry *e = entry_add(target, final_key);
         e->line_num = line_no;
+        e->src_off = val_off;
+        e->src_len = truncated || open_quote ? 0 : strlen(val);
         strncpy(e->comment, comment, sizeof(e->comment)-1);
 
         // Detect multiline string
         if (starts_with(val, "\"\"\"")) {
+            e->type = TOML_STRING;
+
+            // closed on the opening line: a = """text"""
+            char *close = strstr(val + 3, "\"\"\"");
+            if (close) {
+                *close = '\0';
+                strncpy(e->value.str_val, val + 3, MAX_VAL_LEN - 1);
+                if (!truncated) e->src_len = (size_t)(close - val) + 3;
+                continue;
+            }
+
             char buf[2048] = "";
-            while (fgets(line, sizeof(line), f)) {
-                if (strstr(line, "\"\"\"")) break;
-                strcat(buf, line);
+            int open_line = line_no;
+            e->src_len = 0; // stays unpatchable unless the closer is found
+            while (line_off = pos, next_line(src, src_len, &pos, line, sizeof(line))) {
+                line_no++;
+                bool cut = strlen(line) < pos - line_off;
+                close = strstr(line, "\"\"\"");
+                if (close) {
+                    if (!truncated && !cut)
+                        e->src_len = line_off + (size_t)(close - line) + 3 - val_off;
+                    break;
+                }
+                if (cut) truncated = true;
+                if (strlen(buf) + strlen(line) < sizeof(buf)) strcat(buf, line);
             }
-            e->type = TOML_STRING;
+            if (!close) err_add(&doc->errs, open_line, "unterminated multiline string");
             strncpy(e->value.str_val, buf, MAX_VAL_LEN - 1);
             continue;
         }
@@ -281,7 +417,10 @@ TomlDoc *toml_load(const char *filename) {
             strncpy(inner, val+1, strlen(val)-2);
             inner[strlen(val)-2] = '\0';
             e->type = TOML_TABLE;
-            e->value.table_val = parse_inline_table(inner);
+            e->value.table_val = parse_inline_table(inner, val_off + 1);
+            if (truncated)
+                for (int i = 0; i < e->value.table_val->entry_count; i++)
+                    e->value.table_val->entries[i].src_len = 0;
             continue;
         }
 
@@ -319,11 +458,10 @@ TomlDoc *toml_load(const char *filename) {
         if (strchr(val, '.')) {
             e->type = TOML_FLOAT; e->value.float_val = atof(val);
         } else {
-            e->type = TOML_INT; e->value.int_val = atoi(val);
+            e->type = TOML_INT; e->value.int_val = strtoll(val, NULL, 10);
         }
     }
 
-    fclose(f);
     return doc;
 }
 
@@ -331,6 +469,7 @@ TomlDoc *toml_load(const char *filename) {
 // Accessors
 // ------------------------------------------------------------
 TomlTable *toml_table_get(TomlTable *p, const char *name) {
+    p = array_scope(p);
     for (int i=0;i<p->sub_count;i++)
         if (!strcmp(p->subtables[i]->name,name))
             return p->subtables[i];
@@ -338,6 +477,7 @@ TomlTable *toml_table_get(TomlTable *p, const char *name) {
 }
 
 const TomlEntry *toml_entry_get(const TomlTable *t,const char *key){
+    t = array_scope((TomlTable *)t);
     for (int i=0;i<t->entry_count;i++)
         if (!strcmp(t->entries[i].key,key))
             return &t->entries[i];
@@ -345,6 +485,11 @@ const TomlEntry *toml_entry_get(const TomlTable *t,const char *key){
 }
 
 int toml_get_int(const TomlTable *t,const char *k,int def){
+    const TomlEntry *e=toml_entry_get(t,k);
+    if(!e||e->type!=TOML_INT||e->value.int_val<INT_MIN||e->value.int_val>INT_MAX)return def;
+    return (int)e->value.int_val;
+}
+int64_t toml_get_int64(const TomlTable *t,const char *k,int64_t def){
     const TomlEntry *e=toml_entry_get(t,k);
     return (e&&e->type==TOML_INT)?e->value.int_val:def;
 }
@@ -361,6 +506,44 @@ const char* toml_get_string(const TomlTable *t,const char *k,const char *def){
     return (e&&e->type==TOML_STRING)?e->value.str_val:def;
 }
 
+// ------------------------------------------------------------
+// Setters
+// ------------------------------------------------------------
+static TomlEntry *entry_for_set(TomlTable *t,const char *k){
+    t = array_scope(t);
+    for(int i=0;i<t->entry_count;i++){
+        TomlEntry *e=&t->entries[i];
+        if(strcmp(e->key,k))continue;
+        if(e->type==TOML_TABLE)free_table(e->value.table_val);
+        memset(&e->value,0,sizeof(e->value));
+        e->dirty=true;
+        return e;
+    }
+    return NULL;
+}
+
+int toml_set_int(TomlTable *t,const char *k,int v){
+    TomlEntry *e=entry_for_set(t,k); if(!e)return -1;
+    e->type=TOML_INT; e->value.int_val=v; return 0;
+}
+int toml_set_int64(TomlTable *t,const char *k,int64_t v){
+    TomlEntry *e=entry_for_set(t,k); if(!e)return -1;
+    e->type=TOML_INT; e->value.int_val=v; return 0;
+}
+int toml_set_float(TomlTable *t,const char *k,double v){
+    TomlEntry *e=entry_for_set(t,k); if(!e)return -1;
+    e->type=TOML_FLOAT; e->value.float_val=v; return 0;
+}
+int toml_set_bool(TomlTable *t,const char *k,bool v){
+    TomlEntry *e=entry_for_set(t,k); if(!e)return -1;
+    e->type=TOML_BOOL; e->value.bool_val=v; return 0;
+}
+int toml_set_string(TomlTable *t,const char *k,const char *v){
+    if(strlen(v)>=MAX_VAL_LEN)return -1; // would not fit str_val
+    TomlEntry *e=entry_for_set(t,k); if(!e)return -1;
+    e->type=TOML_STRING; memcpy(e->value.str_val,v,strlen(v)+1); return 0;
+}
+
 // ------------------------------------------------------------
 // Validation
 // ------------------------------------------------------------
@@ -398,67 +581,154 @@ static void write_escaped_string(FILE *f,const char *s){
     }}fputc('"',f);
 }
 
+// Shortest form that reads back as the same double, always with a '.'
+// or exponent so the parser does not take it for an integer.
+static void write_float(FILE *f,double v){
+    char buf[32];
+    snprintf(buf,sizeof(buf),"%.15g",v);
+    if(strtod(buf,NULL)!=v)snprintf(buf,sizeof(buf),"%.17g",v);
+    fputs(buf,f);
+    if(!strpbrk(buf,".eEn"))fputs(".0",f);
+}
+
 static void write_array(FILE *f,const TomlEntry *e){
     fprintf(f,"[");
     for(int i=0;i<e->value.array.length;i++){
         if(i>0)fprintf(f,", ");
-        if(e->type==TOML_ARRAY_INT)fprintf(f,"%d",e->value.array.ints[i]);
-        else if(e->type==TOML_ARRAY_FLOAT)fprintf(f,"%g",e->value.array.floats[i]);
+        if(e->type==TOML_ARRAY_INT)fprintf(f,"%" PRId64,e->value.array.ints[i]);
+        else if(e->type==TOML_ARRAY_FLOAT)write_float(f,e->value.array.floats[i]);
         else if(e->type==TOML_ARRAY_STRING)write_escaped_string(f,e->value.array.strings[i]);
     }
     fprintf(f,"]");
 }
 
-static void write_table(FILE *f,const TomlTable *t,int depth,int indent){
+static void write_value(FILE *f,const TomlEntry *e){
+    switch(e->type){
+        case TOML_INT:fprintf(f,"%" PRId64,e->value.int_val);break;
+        case TOML_FLOAT:write_float(f,e->value.float_val);break;
+        case TOML_BOOL:fprintf(f,e->value.bool_val?"true":"false");break;
+        case TOML_STRING:write_escaped_string(f,e->value.str_val);break;
+        case TOML_ARRAY_INT:
+        case TOML_ARRAY_FLOAT:
+        case TOML_ARRAY_STRING:write_array(f,e);break;
+        case TOML_DATETIME:
+            fprintf(f,"%04d-%02d-%02dT%02d:%02d:%02dZ",
+                    e->value.datetime.year,e->value.datetime.month,
+                    e->value.datetime.day,e->value.datetime.hour,
+                    e->value.datetime.minute,e->value.datetime.second);
+            break;
+        case TOML_TABLE:
+            fprintf(f,"{"); for(int j=0;j<e->value.table_val->entry_count;j++){
+                const TomlEntry *ie=&e->value.table_val->entries[j];
+                if(j>0)fprintf(f,", ");
+                fprintf(f,"%s = ",ie->key);
+                write_value(f,ie);
+            } fprintf(f,"}");
+            break;
+    }
+}
+
+// Header name for a subtable: full dotted path so nested tables re-read
+// into the same place.
+static void child_path(char *out,size_t cap,const char *path,const char *name){
+    if(*path)snprintf(out,cap,"%s.%s",path,name);
+    else snprintf(out,cap,"%s",name);
+}
+
+static void write_table(FILE *f,const TomlTable *t,int depth,int indent,const char *path){
     if(strlen(t->comment)>0)fprintf(f,"#%s\n",t->comment);
     for(int i=0;i<t->entry_count;i++){
         const TomlEntry *e=&t->entries[i];
         write_indent(f,depth,indent);
         fprintf(f,"%s = ",e->key);
-        switch(e->type){
-            case TOML_INT:fprintf(f,"%d",e->value.int_val);break;
-            case TOML_FLOAT:fprintf(f,"%g",e->value.float_val);break;
-            case TOML_BOOL:fprintf(f,e->value.bool_val?"true":"false");break;
-            case TOML_STRING:write_escaped_string(f,e->value.str_val);break;
-            case TOML_ARRAY_INT:
-            case TOML_ARRAY_FLOAT:
-            case TOML_ARRAY_STRING:write_array(f,e);break;
-            case TOML_DATETIME:
-                fprintf(f,"%04d-%02d-%02dT%02d:%02d:%02dZ",
-                        e->value.datetime.year,e->value.datetime.month,
-                        e->value.datetime.day,e->value.datetime.hour,
-                        e->value.datetime.minute,e->value.datetime.second);
-                break;
-            case TOML_TABLE:
-                fprintf(f,"{"); for(int j=0;j<e->value.table_val->entry_count;j++){
-                    const TomlEntry *ie=&e->value.table_val->entries[j];
-                    if(j>0)fprintf(f,", ");
-                    fprintf(f,"%s = ",ie->key);
-                    if(ie->type==TOML_STRING)write_escaped_string(f,ie->value.str_val);
-                    else if(ie->type==TOML_INT)fprintf(f,"%d",ie->value.int_val);
-                    else if(ie->type==TOML_BOOL)fprintf(f,ie->value.bool_val?"true":"false");
-                    else if(ie->type==TOML_FLOAT)fprintf(f,"%g",ie->value.float_val);
-                } fprintf(f,"}");
-                break;
-        }
+        write_value(f,e);
         if(strlen(e->comment)>0)fprintf(f,"  # %s",e->comment);
         fprintf(f,"\n");
     }
     for(int i=0;i<t->sub_count;i++){
-        fprintf(f,"\n");
         const TomlTable *st=t->subtables[i];
-        write_indent(f,depth,indent);fprintf(f,"[%s]\n",st->name);
-        write_table(f,st,depth+1,indent);
+        char sub[512];
+        child_path(sub,sizeof(sub),path,st->name);
+        if(st->is_array){
+            for(int j=0;j<st->arr_count;j++){
+                fprintf(f,"\n");
+                write_indent(f,depth,indent);fprintf(f,"[[%s]]\n",sub);
+                write_table(f,st->table_array[j],depth+1,indent,sub);
+            }
+            // anything hung on the container itself re-reads into the last element
+            write_table(f,st,depth+1,indent,sub);
+            continue;
+        }
+        fprintf(f,"\n");
+        write_indent(f,depth,indent);fprintf(f,"[%s]\n",sub);
+        write_table(f,st,depth+1,indent,sub);
     }
 }
 
 int toml_write(const TomlDoc *doc,const char *file,const TomlWriteOptions *opts){
     FILE *f=fopen(file,"w"); if(!f)return -1;
     int ind=opts?opts->indent_spaces:0;
-    write_table(f,doc->root,0,ind);
+    write_table(f,doc->root,0,ind,"");
     fclose(f); return 0;
 }
 
+// ------------------------------------------------------------
+// Patch Writer
+// ------------------------------------------------------------
+typedef struct {
+    const TomlEntry **items;
+    int count, cap;
+} EntryList;
+
+static void collect_dirty(EntryList *l,const TomlTable *t){
+    for(int i=0;i<t->entry_count;i++){
+        const TomlEntry *e=&t->entries[i];
+        if(e->type==TOML_TABLE&&e->value.table_val)collect_dirty(l,e->value.table_val);
+        if(!e->dirty)continue;
+        if(l->count>=l->cap){
+            l->cap=l->cap?l->cap*2:8;
+            l->items=realloc(l->items,l->cap*sizeof(TomlEntry *));
+        }
+        l->items[l->count++]=e;
+    }
+    for(int i=0;i<t->sub_count;i++)collect_dirty(l,t->subtables[i]);
+    for(int i=0;i<t->arr_count;i++)collect_dirty(l,t->table_array[i]);
+}
+
+static int cmp_src_off(const void *a,const void *b){
+    const TomlEntry *x=*(const TomlEntry *const *)a,*y=*(const TomlEntry *const *)b;
+    return (x->src_off>y->src_off)-(x->src_off<y->src_off);
+}
+
+int toml_patch_write(const TomlDoc *doc,const char *file){
+    if(!doc->src)return -1;
+    EntryList l={0};
+    collect_dirty(&l,doc->root);
+    if(l.count)qsort(l.items,l.count,sizeof(TomlEntry *),cmp_src_off);
+
+    // Every edit must map onto its own slice of the original text
+    size_t end=0;
+    for(int i=0;i<l.count;i++){
+        const TomlEntry *e=l.items[i];
+        if(!e->src_len||e->src_off<end||e->src_off+e->src_len>doc->src_len){
+            free(l.items); return -1;
+        }
+        end=e->src_off+e->src_len;
+    }
+
+    FILE *f=fopen(file,"wb"); if(!f){free(l.items);return -1;}
+    size_t pos=0;
+    for(int i=0;i<l.count;i++){
+        const TomlEntry *e=l.items[i];
+        fwrite(doc->src+pos,1,e->src_off-pos,f);
+        write_value(f,e);
+        pos=e->src_off+e->src_len;
+    }
+    fwrite(doc->src+pos,1,doc->src_len-pos,f);
+    free(l.items);
+    return fclose(f)==0?0:-1;
+}
+
 // ------------------------------------------------------------
 // Dump / Free
 // ------------------------------------------------------------
@@ -477,6 +747,8 @@ void toml_dump(const TomlDoc *doc){dump_table(doc->root,0);}
 
 static void free_table(TomlTable *t){
     if(!t)return;
+    for(int i=0;i<t->entry_count;i++)
+        if(t->entries[i].type==TOML_TABLE)free_table(t->entries[i].value.table_val);
     for(int i=0;i<t->sub_count;i++)free_table(t->subtables[i]);
     for(int i=0;i<t->arr_count;i++)free_table(t->table_array[i]);
     free(t->entries); free(t->subtables); free(t->table_array); free(t);
@@ -485,5 +757,6 @@ void toml_free(TomlDoc *d){
     if(!d)return;
     free_table(d->root);
     free(d->errs.errors);
+    free(d->src);
     free(d);
 }
\ No newline at end of file
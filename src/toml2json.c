@@ -0,0 +1,24 @@
+#include "toml.h"
+#include <stdio.h>
+
+// toml2json [input.toml [output.json]] -- stdin/stdout when omitted
+int main(int argc, char **argv) {
+    if (argc > 3) {
+        fprintf(stderr, "usage: %s [input.toml [output.json]]\n", argv[0]);
+        return 2;
+    }
+    FILE *in = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (!in) { fprintf(stderr, "cannot open %s\n", argv[1]); return 1; }
+    FILE *out = argc > 2 ? fopen(argv[2], "wb") : stdout;
+    if (!out) { fprintf(stderr, "cannot open %s\n", argv[2]); return 1; }
+
+    TomlError err = {0};
+    int rc = toml_to_json(in, out, &err);
+    if (rc != 0)
+        fprintf(stderr, "%s:%d: %s\n", argc > 1 ? argv[1] : "<stdin>",
+                err.line, err.message);
+
+    if (in != stdin) fclose(in);
+    if (out != stdout && fclose(out) != 0) rc = -1;
+    return rc == 0 ? 0 : 1;
+}
@@ -0,0 +1,819 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "toml.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+// Streaming TOML -> JSON. The input is lexed straight out of a fixed
+// read buffer and JSON is emitted into a fixed write buffer, so memory
+// use does not depend on document size. Only the open table path is
+// kept, so tables and dotted-key prefixes must appear contiguously; one
+// that is reopened later is emitted again as a duplicate JSON key (see
+// toml.h).
+
+#define JSON_IN_BUF   (64 * 1024)
+#define JSON_OUT_BUF  (64 * 1024)
+#define JSON_MAX_DEPTH 32
+
+typedef struct {
+    char name[MAX_KEY_LEN];
+    bool is_array; // "name":[{ ... }] rather than "name":{ ... }
+    int members;
+} JsonLevel;
+
+typedef struct {
+    FILE *in, *out;
+    size_t pos, len;
+    bool eof;
+    int line;
+
+    size_t olen;
+    bool write_failed;
+
+    JsonLevel levels[JSON_MAX_DEPTH + 1]; // [0] is the root object
+    int depth, table_depth;
+    int array_depth; // open [ ... ] values; shares the JSON_MAX_DEPTH budget
+
+    char keys[JSON_MAX_DEPTH][MAX_KEY_LEN]; // segments of the key being read
+    int key_count;
+    char *key_dst;   // when set, decoded string bytes go here instead of out
+    size_t key_len;
+
+    TomlError *err;
+    bool failed;
+
+    char ibuf[JSON_IN_BUF];
+    char obuf[JSON_OUT_BUF];
+} JsonStream;
+
+// ------------------------------------------------------------
+// Character classes
+// ------------------------------------------------------------
+// One table lookup instead of a chain of compares in the scanning loops.
+enum {
+    C_SAFE = 1, // may be copied into a JSON string as-is
+    C_BARE = 2, // bare-key character
+    C_END  = 4, // ends a bare scalar
+    C_WS   = 8  // space or tab
+};
+
+#define S C_SAFE
+#define B (C_SAFE | C_BARE)
+#define E C_END
+static const unsigned char char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, E|C_WS, E, 0, 0, E, 0, 0,          // \t \n \r
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    S|E|C_WS, S, 0, S|E, S, S, S, S, S, S, S, S, S|E, B, S, S,    // ' ' " # , -
+    B, B, B, B, B, B, B, B, B, B, S, S, S, S, S, S,               // 0-9
+    S, B, B, B, B, B, B, B, B, B, B, B, B, B, B, B,               // A-O
+    B, B, B, B, B, B, B, B, B, B, B, S, 0, S|E, S, B,             // P-Z \\ ] _
+    S, B, B, B, B, B, B, B, B, B, B, B, B, B, B, B,               // a-o
+    B, B, B, B, B, B, B, B, B, B, B, S, S, S|E, S, S,             // p-z }
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,               // 0x80-0xFF
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+};
+#undef S
+#undef B
+#undef E
+
+static bool has_class(int c, int cls) { return c != EOF && (char_class[c] & cls); }
+
+// ------------------------------------------------------------
+// Errors
+// ------------------------------------------------------------
+static void fail(JsonStream *s, const char *msg) {
+    if (s->failed) return;
+    s->failed = true;
+    if (s->err) {
+        s->err->line = s->line;
+        strncpy(s->err->message, msg, sizeof(s->err->message) - 1);
+        s->err->message[sizeof(s->err->message) - 1] = '\0';
+    }
+}
+
+// ------------------------------------------------------------
+// Input
+// ------------------------------------------------------------
+// Makes at least n bytes available past pos unless the input ends first.
+static void fill(JsonStream *s, size_t n) {
+    if (s->len - s->pos >= n || s->eof) return;
+    memmove(s->ibuf, s->ibuf + s->pos, s->len - s->pos);
+    s->len -= s->pos;
+    s->pos = 0;
+    while (s->len < n && !s->eof) {
+        size_t got = fread(s->ibuf + s->len, 1, JSON_IN_BUF - s->len, s->in);
+        if (got == 0) s->eof = true;
+        s->len += got;
+    }
+}
+
+static int peek_at(JsonStream *s, size_t k) {
+    if (s->pos + k < s->len) return (unsigned char)s->ibuf[s->pos + k];
+    fill(s, k + 1);
+    return s->pos + k < s->len ? (unsigned char)s->ibuf[s->pos + k] : EOF;
+}
+
+static int peek(JsonStream *s) { return peek_at(s, 0); }
+
+static void advance(JsonStream *s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        if (s->ibuf[s->pos + i] == '\n') s->line++;
+    s->pos += n;
+}
+
+static void skip_ws(JsonStream *s) {
+    while (has_class(peek(s), C_WS)) {
+        const char *p = s->ibuf + s->pos, *end = s->ibuf + s->len;
+        while (p < end && (char_class[(unsigned char)*p] & C_WS)) p++;
+        s->pos = (size_t)(p - s->ibuf);
+    }
+}
+
+// Stops on the newline (or EOF) that ends the comment.
+static void skip_comment(JsonStream *s) {
+    if (peek(s) != '#') return;
+    while (peek(s) != EOF) {
+        const char *p = s->ibuf + s->pos;
+        const char *nl = memchr(p, '\n', s->len - s->pos);
+        if (nl) { s->pos = (size_t)(nl - s->ibuf); return; }
+        s->pos = s->len;
+    }
+}
+
+// Skips whitespace, newlines and comments (inside arrays and between lines).
+static void skip_blank(JsonStream *s) {
+    for (;;) {
+        skip_ws(s);
+        skip_comment(s);
+        int c = peek(s);
+        if (c == '\r' || c == '\n') { advance(s, 1); continue; }
+        return;
+    }
+}
+
+// Consumes the rest of a key/value or header line.
+static void expect_eol(JsonStream *s) {
+    skip_ws(s);
+    skip_comment(s);
+    int c = peek(s);
+    if (c == '\r') { s->pos++; c = peek(s); }
+    if (c == '\n') advance(s, 1);
+    else if (c != EOF) fail(s, "expected end of line");
+}
+
+// ------------------------------------------------------------
+// Output
+// ------------------------------------------------------------
+static void flush_out(JsonStream *s) {
+    if (s->olen && fwrite(s->obuf, 1, s->olen, s->out) != s->olen)
+        s->write_failed = true;
+    s->olen = 0;
+}
+
+static void emit_mem(JsonStream *s, const char *p, size_t n) {
+    if (s->olen + n > JSON_OUT_BUF) {
+        flush_out(s);
+        if (n > JSON_OUT_BUF) {
+            if (fwrite(p, 1, n, s->out) != n) s->write_failed = true;
+            return;
+        }
+    }
+    memcpy(s->obuf + s->olen, p, n);
+    s->olen += n;
+}
+
+static void emit_char(JsonStream *s, char c) {
+    if (s->olen == JSON_OUT_BUF) flush_out(s);
+    s->obuf[s->olen++] = c;
+}
+
+static void emit_str(JsonStream *s, const char *p) { emit_mem(s, p, strlen(p)); }
+
+static bool json_safe(unsigned char c) { return char_class[c] & C_SAFE; }
+
+// Writes one decoded string byte, JSON-escaped, or appends it to key_dst.
+static void put_byte(JsonStream *s, unsigned char c) {
+    if (s->key_dst) {
+        if (s->key_len < MAX_KEY_LEN - 1) s->key_dst[s->key_len++] = (char)c;
+        return;
+    }
+    if (json_safe(c)) { emit_char(s, (char)c); return; }
+    switch (c) {
+        case '"':  emit_str(s, "\\\""); break;
+        case '\\': emit_str(s, "\\\\"); break;
+        case '\b': emit_str(s, "\\b"); break;
+        case '\f': emit_str(s, "\\f"); break;
+        case '\n': emit_str(s, "\\n"); break;
+        case '\r': emit_str(s, "\\r"); break;
+        case '\t': emit_str(s, "\\t"); break;
+        default: {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            emit_str(s, esc);
+        }
+    }
+}
+
+static void put_utf8(JsonStream *s, unsigned long cp) {
+    if (cp < 0x80) put_byte(s, (unsigned char)cp);
+    else if (cp < 0x800) {
+        put_byte(s, (unsigned char)(0xC0 | (cp >> 6)));
+        put_byte(s, (unsigned char)(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        put_byte(s, (unsigned char)(0xE0 | (cp >> 12)));
+        put_byte(s, (unsigned char)(0x80 | ((cp >> 6) & 0x3F)));
+        put_byte(s, (unsigned char)(0x80 | (cp & 0x3F)));
+    } else {
+        put_byte(s, (unsigned char)(0xF0 | (cp >> 18)));
+        put_byte(s, (unsigned char)(0x80 | ((cp >> 12) & 0x3F)));
+        put_byte(s, (unsigned char)(0x80 | ((cp >> 6) & 0x3F)));
+        put_byte(s, (unsigned char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+static void emit_key(JsonStream *s, const char *key) {
+    emit_char(s, '"');
+    while (*key) {
+        const char *run = key;
+        while (*key && json_safe((unsigned char)*key)) key++;
+        emit_mem(s, run, (size_t)(key - run));
+        if (*key) put_byte(s, (unsigned char)*key++);
+    }
+    emit_str(s, "\":");
+}
+
+// ------------------------------------------------------------
+// Strings
+// ------------------------------------------------------------
+// Copies a run of bytes that need no decoding in one go. Newlines in a
+// multi-line string are escaped here too rather than one put_byte() each.
+static void copy_run(JsonStream *s, char quote, bool multi) {
+    if (s->key_dst) return;
+    if (s->pos == s->len) fill(s, 1);
+    const char *p = s->ibuf + s->pos, *end = s->ibuf + s->len;
+    for (;;) {
+        const char *start = p;
+        while (p < end && json_safe((unsigned char)*p) && *p != quote) p++;
+        emit_mem(s, start, (size_t)(p - start));
+        if (!multi || p == end || *p != '\n') break;
+        emit_mem(s, "\\n", 2);
+        s->line++;
+        p++;
+    }
+    s->pos = (size_t)(p - s->ibuf);
+}
+
+// An escape JSON spells the same way is copied through as-is.
+static void put_short_escape(JsonStream *s, char c, unsigned char decoded) {
+    if (s->key_dst) { put_byte(s, decoded); return; }
+    char esc[2] = {'\\', c};
+    emit_mem(s, esc, 2);
+}
+
+static void read_escape(JsonStream *s) {
+    int c = peek(s);
+    if (c == EOF) { fail(s, "unterminated string"); return; }
+    s->pos++;
+    switch (c) {
+        case 'b': put_short_escape(s, 'b', '\b'); return;
+        case 't': put_short_escape(s, 't', '\t'); return;
+        case 'n': put_short_escape(s, 'n', '\n'); return;
+        case 'f': put_short_escape(s, 'f', '\f'); return;
+        case 'r': put_short_escape(s, 'r', '\r'); return;
+        case 'e': put_byte(s, 0x1B); return;
+        case '"': put_short_escape(s, '"', '"'); return;
+        case '\\': put_short_escape(s, '\\', '\\'); return;
+        case 'u':
+        case 'U': {
+            int digits = c == 'u' ? 4 : 8;
+            unsigned long cp = 0;
+            for (int i = 0; i < digits; i++) {
+                int h = peek(s);
+                if (!isxdigit(h)) { fail(s, "bad unicode escape"); return; }
+                cp = cp * 16 + (unsigned long)(isdigit(h) ? h - '0' : (tolower(h) - 'a' + 10));
+                s->pos++;
+            }
+            if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                fail(s, "bad unicode escape");
+                return;
+            }
+            put_utf8(s, cp);
+            return;
+        }
+        default: fail(s, "bad escape sequence");
+    }
+}
+
+// Reads a basic or literal string, single or multi-line, with the cursor
+// on the opening quote. Decoded bytes go through put_byte().
+static void read_string(JsonStream *s) {
+    char q = (char)peek(s);
+    bool basic = q == '"';
+    bool multi = peek_at(s, 1) == q && peek_at(s, 2) == q;
+    advance(s, multi ? 3 : 1);
+    if (multi) { // a newline right after the opening delimiter is trimmed
+        if (peek(s) == '\r' && peek_at(s, 1) == '\n') advance(s, 2);
+        else if (peek(s) == '\n') advance(s, 1);
+    }
+    for (;;) {
+        if (s->failed) return;
+        copy_run(s, q, multi);
+        int c = peek(s);
+        if (c == EOF) { fail(s, "unterminated string"); return; }
+        if (c == q) {
+            if (!multi) { s->pos++; return; }
+            int n = 0;
+            while (n < 5 && peek_at(s, (size_t)n) == q) n++;
+            if (n >= 3) { // up to two quotes may sit right before the closer
+                for (int i = 3; i < n; i++) put_byte(s, (unsigned char)q);
+                s->pos += (size_t)n;
+                return;
+            }
+            for (int i = 0; i < n; i++) put_byte(s, (unsigned char)q);
+            s->pos += (size_t)n;
+            continue;
+        }
+        if (c == '\n' && !multi) { fail(s, "newline in string"); return; }
+        if (c == '\\' && basic) {
+            s->pos++;
+            int n = peek(s);
+            if (multi && (n == ' ' || n == '\t' || n == '\r' || n == '\n')) {
+                // line-ending backslash swallows the following whitespace
+                while ((n = peek(s)) == ' ' || n == '\t' || n == '\r' || n == '\n')
+                    advance(s, 1);
+                continue;
+            }
+            read_escape(s);
+            continue;
+        }
+        put_byte(s, (unsigned char)c);
+        advance(s, 1);
+    }
+}
+
+// ------------------------------------------------------------
+// Keys
+// ------------------------------------------------------------
+static bool is_bare(int c) { return has_class(c, C_BARE); }
+
+// Reads a (possibly dotted, possibly quoted) key into s->keys.
+static void read_key(JsonStream *s) {
+    s->key_count = 0;
+    for (;;) {
+        skip_ws(s);
+        if (s->key_count == JSON_MAX_DEPTH) { fail(s, "key nested too deep"); return; }
+        char *dst = s->keys[s->key_count++];
+        int c = peek(s);
+        size_t n = 0;
+        if (c == '"' || c == '\'') {
+            if (peek_at(s, 1) == c && peek_at(s, 2) == c) { fail(s, "multiline key"); return; }
+            s->key_dst = dst;
+            s->key_len = 0;
+            read_string(s);
+            n = s->key_len;
+            s->key_dst = NULL;
+        } else {
+            while (is_bare(peek(s))) { // scan whole runs of the read buffer
+                const char *start = s->ibuf + s->pos, *p = start, *end = s->ibuf + s->len;
+                while (p < end && is_bare((unsigned char)*p)) p++;
+                size_t take = (size_t)(p - start);
+                s->pos += take;
+                if (take > MAX_KEY_LEN - 1 - n) take = MAX_KEY_LEN - 1 - n;
+                memcpy(dst + n, start, take);
+                n += take;
+            }
+            if (n == 0) { fail(s, "expected key"); return; }
+        }
+        dst[n] = '\0';
+        skip_ws(s);
+        if (peek(s) != '.') return;
+        s->pos++;
+    }
+}
+
+// ------------------------------------------------------------
+// Object nesting
+// ------------------------------------------------------------
+static void begin_member(JsonStream *s) {
+    if (s->levels[s->depth].members++) emit_char(s, ',');
+}
+
+static bool push_level(JsonStream *s, const char *name, bool is_array) {
+    if (s->depth == JSON_MAX_DEPTH) { fail(s, "tables nested too deep"); return false; }
+    JsonLevel *l = &s->levels[++s->depth];
+    size_t n = strlen(name); // keys are already bounded by MAX_KEY_LEN
+    memcpy(l->name, name, n + 1);
+    l->is_array = is_array;
+    l->members = 0;
+    return true;
+}
+
+static void open_level(JsonStream *s, const char *name, bool is_array) {
+    begin_member(s);
+    emit_key(s, name);
+    emit_str(s, is_array ? "[{" : "{");
+    push_level(s, name, is_array);
+}
+
+static void close_to(JsonStream *s, int depth) {
+    while (s->depth > depth)
+        emit_str(s, s->levels[s->depth--].is_array ? "}]" : "}");
+}
+
+// Opens the dotted prefix keys[0..key_count-2] below the given base depth,
+// reusing whatever part of it the previous key already opened.
+static void enter_prefix(JsonStream *s, int base) {
+    int m = 0;
+    while (m < s->key_count - 1 && base + m < s->depth &&
+           !s->levels[base + m + 1].is_array &&
+           !strcmp(s->levels[base + m + 1].name, s->keys[m]))
+        m++;
+    close_to(s, base + m);
+    for (int i = m; i < s->key_count - 1 && !s->failed; i++)
+        open_level(s, s->keys[i], false);
+}
+
+// ------------------------------------------------------------
+// Values
+// ------------------------------------------------------------
+static void read_value(JsonStream *s);
+
+static bool is_scalar_end(int c) { return c == EOF || (char_class[c] & C_END); }
+
+static const char *skip_digits(const char *p) {
+    while (*p >= '0' && *p <= '9') p++;
+    return p;
+}
+
+// -?int(.frac)?(e[+-]?exp)? with no leading zeros: valid as both TOML and JSON
+static bool is_number(const char *p) {
+    if (*p == '-') p++;
+    const char *q = skip_digits(p);
+    if (q == p || (*p == '0' && q - p > 1)) return false;
+    if (*q == '.') {
+        p = q + 1;
+        q = skip_digits(p);
+        if (q == p) return false;
+    }
+    if (*q == 'e' || *q == 'E') {
+        p = q + 1;
+        if (*p == '+' || *p == '-') p++;
+        q = skip_digits(p);
+        if (q == p) return false;
+    }
+    return *q == '\0';
+}
+
+// A decimal integer of n bytes that fits in TOML's signed 64-bit range.
+static bool int64_in_range(const char *p, size_t n) {
+    bool neg = *p == '-';
+    if (neg) p++;
+    size_t digits = n - neg;
+    if (digits < 19) return true;
+    if (digits > 19) return false;
+    return strcmp(p, neg ? "9223372036854775808" : "9223372036854775807") <= 0;
+}
+
+static bool all_digits(const char *p, int n) {
+    for (int i = 0; i < n; i++)
+        if (p[i] < '0' || p[i] > '9') return false;
+    return true;
+}
+
+static int two_digits(const char *p) { return (p[0] - '0') * 10 + (p[1] - '0'); }
+
+// HH:MM:SS(.frac)?; *end is set past it.
+static bool is_time(const char *p, const char **end) {
+    if (!all_digits(p, 2) || p[2] != ':' || !all_digits(p + 3, 2) ||
+        p[5] != ':' || !all_digits(p + 6, 2))
+        return false;
+    if (two_digits(p) > 23 || two_digits(p + 3) > 59 || two_digits(p + 6) > 60)
+        return false;
+    p += 8;
+    if (*p == '.') {
+        const char *q = skip_digits(p + 1);
+        if (q == p + 1) return false;
+        p = q;
+    }
+    *end = p;
+    return true;
+}
+
+// RFC 3339 as TOML uses it: offset/local date-time, local date or local time.
+static bool is_datetime(const char *tok) {
+    static const int mdays[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const char *p;
+    if (tok[2] == ':') return is_time(tok, &p) && *p == '\0';
+
+    if (!all_digits(tok, 4) || tok[4] != '-' || !all_digits(tok + 5, 2) ||
+        tok[7] != '-' || !all_digits(tok + 8, 2))
+        return false;
+    int year = (tok[0] - '0') * 1000 + (tok[1] - '0') * 100 + two_digits(tok + 2);
+    int month = two_digits(tok + 5), day = two_digits(tok + 8);
+    if (month < 1 || month > 12 || day < 1 || day > mdays[month - 1]) return false;
+    if (month == 2 && day == 29 && !(year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)))
+        return false;
+
+    p = tok + 10;
+    if (*p == '\0') return true;
+    if ((*p != 'T' && *p != 't') || !is_time(p + 1, &p)) return false;
+    if (*p == '\0') return true;
+    if (*p == 'Z' || *p == 'z') return p[1] == '\0';
+    if (*p != '+' && *p != '-') return false;
+    return all_digits(p + 1, 2) && p[3] == ':' && all_digits(p + 4, 2) && p[6] == '\0' &&
+           two_digits(p + 1) <= 23 && two_digits(p + 4) <= 59;
+}
+
+static int digit_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 99;
+}
+
+static void emit_scalar(JsonStream *s, char *tok, size_t n) {
+    if ((tok[0] == 't' && !strcmp(tok, "true")) || (tok[0] == 'f' && !strcmp(tok, "false"))) {
+        emit_mem(s, tok, n);
+        return;
+    }
+
+    // Dates and times become RFC 3339 strings, as TomlDatetime would print
+    if ((n >= 10 && tok[4] == '-' && isdigit((unsigned char)tok[0])) ||
+        (n >= 8 && tok[2] == ':')) {
+        if (!is_datetime(tok)) { fail(s, "invalid datetime"); return; }
+        emit_char(s, '"');
+        emit_mem(s, tok, n);
+        emit_char(s, '"');
+        return;
+    }
+
+    // inf/nan have no JSON spelling; keep them as strings
+    const char *bare = (tok[0] == '+' || tok[0] == '-') ? tok + 1 : tok;
+    if ((bare[0] == 'i' || bare[0] == 'n') && (!strcmp(bare, "inf") || !strcmp(bare, "nan"))) {
+        emit_char(s, '"');
+        emit_str(s, tok[0] == '+' ? tok + 1 : tok);
+        emit_char(s, '"');
+        return;
+    }
+
+    // Numbers: drop '_' separators and a leading '+', which JSON rejects
+    size_t w = 0;
+    bool is_float = false;
+    for (size_t i = (tok[0] == '+'); i < n; i++) {
+        if (tok[i] == '.' || tok[i] == 'e' || tok[i] == 'E') is_float = true;
+        if (tok[i] != '_') tok[w++] = tok[i];
+    }
+    tok[w] = '\0';
+
+    if (tok[0] == '0' && (tok[1] == 'x' || tok[1] == 'o' || tok[1] == 'b')) {
+        int base = tok[1] == 'x' ? 16 : tok[1] == 'o' ? 8 : 2;
+        for (const char *d = tok + 2; *d; d++)
+            if (digit_value(*d) >= base) { fail(s, "invalid integer"); return; }
+        if (!tok[2]) { fail(s, "invalid integer"); return; }
+        errno = 0;
+        unsigned long long v = strtoull(tok + 2, NULL, base);
+        if (errno == ERANGE || v > 9223372036854775807ULL) {
+            fail(s, "integer out of range");
+            return;
+        }
+        char num[24];
+        snprintf(num, sizeof(num), "%llu", v);
+        emit_str(s, num);
+        return;
+    }
+
+    if (!is_number(tok)) { fail(s, "invalid value"); return; }
+    if (!is_float && !int64_in_range(tok, w)) { fail(s, "integer out of range"); return; }
+    emit_mem(s, tok, w);
+}
+
+static void read_scalar(JsonStream *s) {
+    char tok[64];
+    size_t n = 0;
+    for (;;) {
+        // fast path: copy until a delimiter within the current buffer
+        const char *p = s->ibuf + s->pos, *end = s->ibuf + s->len;
+        while (p < end && n < sizeof(tok) - 1 && !is_scalar_end((unsigned char)*p))
+            tok[n++] = *p++;
+        s->pos = (size_t)(p - s->ibuf);
+        int c = peek(s);
+        // "1979-05-27 07:32:00" separates date and time with a space
+        if (c == ' ' && n == 10 && tok[4] == '-' && isdigit(peek_at(s, 1))) c = 'T';
+        else if (is_scalar_end(c)) break;
+        if (n == sizeof(tok) - 1) { fail(s, "value too long"); return; }
+        tok[n++] = (char)c;
+        s->pos++;
+    }
+    tok[n] = '\0';
+    if (n == 0) { fail(s, "expected value"); return; }
+    emit_scalar(s, tok, n);
+}
+
+static void read_array(JsonStream *s) {
+    s->pos++; // '['
+    emit_char(s, '[');
+    s->array_depth++;
+    bool first = true;
+    for (;;) {
+        skip_blank(s);
+        if (s->failed) return;
+        if (peek(s) == ']') { s->pos++; break; }
+        if (!first) {
+            if (peek(s) != ',') { fail(s, "expected ',' in array"); return; }
+            s->pos++;
+            skip_blank(s);
+            if (peek(s) == ']') { s->pos++; break; } // trailing comma
+            emit_char(s, ',');
+        }
+        read_value(s);
+        first = false;
+    }
+    emit_char(s, ']');
+    s->array_depth--;
+}
+
+static void read_keyval(JsonStream *s, int base);
+
+static void read_inline_table(JsonStream *s) {
+    s->pos++; // '{'
+    emit_char(s, '{');
+    if (!push_level(s, "", false)) return;
+    int base = s->depth;
+    skip_ws(s);
+    if (peek(s) == '}') s->pos++;
+    else for (;;) {
+        read_keyval(s, base);
+        if (s->failed) return;
+        skip_ws(s);
+        int c = peek(s);
+        if (c != '}' && c != ',') { fail(s, "expected ',' or '}' in inline table"); return; }
+        s->pos++;
+        if (c == '}') break;
+    }
+    close_to(s, base - 1);
+}
+
+static void read_value(JsonStream *s) {
+    if (s->depth + s->array_depth >= JSON_MAX_DEPTH) { fail(s, "value nested too deep"); return; }
+    int c = peek(s);
+    if (c == '"' || c == '\'') {
+        emit_char(s, '"');
+        read_string(s);
+        emit_char(s, '"');
+    } else if (c == '[') read_array(s);
+    else if (c == '{') read_inline_table(s);
+    else read_scalar(s);
+}
+
+static void read_keyval(JsonStream *s, int base) {
+    read_key(s);
+    if (s->failed) return;
+    if (peek(s) != '=') { fail(s, "missing '='"); return; }
+    s->pos++;
+    skip_ws(s);
+    enter_prefix(s, base);
+    begin_member(s);
+    emit_key(s, s->keys[s->key_count - 1]);
+    read_value(s);
+}
+
+// Fast path for the common one-line `key = value` with a bare key and a
+// scalar or escape-free string, handled straight out of the read buffer.
+// Returns false without consuming anything when the line needs the full
+// lexer above (dotted or quoted keys, arrays, escapes, a split buffer...).
+static bool read_simple_keyval(JsonStream *s) {
+    if (s->depth >= JSON_MAX_DEPTH) return false; // let read_value() report it
+    const char *line = s->ibuf + s->pos, *end = s->ibuf + s->len;
+    const char *p = line;
+    while (p < end && (char_class[(unsigned char)*p] & C_BARE)) p++;
+    size_t key_len = (size_t)(p - line);
+    if (key_len == 0 || key_len >= MAX_KEY_LEN) return false;
+    while (p < end && (char_class[(unsigned char)*p] & C_WS)) p++;
+    if (p == end || *p++ != '=') return false;
+    while (p < end && (char_class[(unsigned char)*p] & C_WS)) p++;
+
+    // bail out on arrays, tables and multi-line strings before looking
+    // for the end of the line
+    const char *val = p;
+    if (end - p < 2 || *p == '[' || *p == '{' ||
+        ((*p == '"' || *p == '\'') && p[1] == *p))
+        return false;
+    const char *nl = memchr(p, '\n', (size_t)(end - p));
+    if (!nl) return false;
+    // *nl is neither a bare, whitespace nor string character, so it stops
+    // every scan below without a separate bounds check
+
+    bool quoted = *p == '"' || *p == '\'';
+    if (quoted) {
+        char q = *p++;
+        while ((char_class[(unsigned char)*p] & C_SAFE) && *p != q) p++;
+        if (*p++ != q) return false; // escape, control byte or no closer
+    } else {
+        while (!(char_class[(unsigned char)*p] & C_END)) p++;
+        // "1979-05-27 07:32:00" continues past the space
+        if (*p == ' ' && p - val == 10 && val[4] == '-') return false;
+    }
+    const char *val_end = p;
+    size_t val_len = (size_t)(val_end - val);
+    if (!quoted && (val_len == 0 || val_len >= 64)) return false;
+
+    while (char_class[(unsigned char)*p] & C_WS) p++;
+    if (*p == '#') p = nl;
+    if (*p == '\r') p++;
+    if (p != nl) return false;
+
+    memcpy(s->keys[0], line, key_len);
+    s->keys[0][key_len] = '\0';
+    s->key_count = 1;
+    enter_prefix(s, s->table_depth);
+    begin_member(s);
+    emit_key(s, s->keys[0]);
+    if (quoted) {
+        emit_char(s, '"');
+        emit_mem(s, val + 1, val_len - 2);
+        emit_char(s, '"');
+    } else {
+        char tok[64];
+        memcpy(tok, val, val_len);
+        tok[val_len] = '\0';
+        emit_scalar(s, tok, val_len);
+    }
+    s->pos = (size_t)(nl + 1 - s->ibuf);
+    s->line++;
+    return true;
+}
+
+// ------------------------------------------------------------
+// Table headers
+// ------------------------------------------------------------
+static void read_header(JsonStream *s) {
+    bool is_array = peek_at(s, 1) == '[';
+    s->pos += is_array ? 2 : 1;
+    read_key(s);
+    if (s->failed) return;
+    if (peek(s) != ']' || (is_array && peek_at(s, 1) != ']')) {
+        fail(s, "unterminated table header");
+        return;
+    }
+    s->pos += is_array ? 2 : 1;
+
+    int n = s->key_count, m = 0;
+    while (m < n && m < s->depth && !strcmp(s->levels[m + 1].name, s->keys[m]))
+        m++;
+
+    if (is_array && m == n && s->levels[n].is_array) {
+        // next element of the array we are already in
+        close_to(s, n);
+        emit_str(s, "},{");
+        s->levels[n].members = 0;
+    } else {
+        if (m == n) m--; // same table again: reopen it
+        close_to(s, m);
+        for (int i = m; i < n - 1; i++) open_level(s, s->keys[i], false);
+        open_level(s, s->keys[n - 1], is_array);
+    }
+    s->table_depth = n;
+    expect_eol(s);
+}
+
+// ------------------------------------------------------------
+// Entry point
+// ------------------------------------------------------------
+int toml_to_json(FILE *in, FILE *out, TomlError *err) {
+    JsonStream *s = calloc(1, sizeof(JsonStream));
+    if (!s) return -1;
+    s->in = in;
+    s->out = out;
+    s->line = 1;
+    s->err = err;
+
+    // skip a UTF-8 byte order mark
+    if (peek(s) == 0xEF && peek_at(s, 1) == 0xBB && peek_at(s, 2) == 0xBF) s->pos += 3;
+
+    emit_char(s, '{');
+    for (;;) {
+        skip_blank(s);
+        if (s->failed || peek(s) == EOF) break;
+        if (peek(s) == '[') read_header(s);
+        else if (!read_simple_keyval(s)) {
+            read_keyval(s, s->table_depth);
+            expect_eol(s);
+        }
+    }
+    close_to(s, 0);
+    emit_str(s, "}\n");
+    flush_out(s);
+
+    if (!s->failed && (s->write_failed || ferror(in))) fail(s, "I/O error");
+    int rc = s->failed ? -1 : 0;
+    free(s);
+    return rc;
+}
@@ -0,0 +1,120 @@
+#include "toml.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <utility>
+
+// Checks for the toml.hpp wrapper; built once as C++17 and once as C++20
+// (the span accessors only exist in the latter).
+
+using namespace ctoml::literals;
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static const char *input =
+    "title = \"wrapper\"\n"
+    "big = 5000000000\n"
+    "small = 42\n"
+    "neg = -1\n"
+    "mixed = [1.5, 2, 3]\n"
+    "\n"
+    "[server]\n"
+    "port = 8080\n"
+    "\n"
+    "[server.config]\n"
+    "timeout = 30\n"
+    "\n"
+    "[[users]]\n"
+    "name = \"Alice\"\n"
+    "age = 30\n"
+    "\n"
+    "[[users]]\n"
+    "name = \"Bob\"\n"
+    "age = 25\n";
+
+static void test_integers(const ctoml::Doc &doc) {
+    CHECK(doc.get<int64_t>("big"_key) == INT64_C(5000000000));
+    CHECK(!doc.get<int>("big"_key));           // does not fit: a miss, not a wrap
+    CHECK(doc.get<int>("big"_key, -7) == -7);
+    CHECK(doc.get<int>("small"_key) == 42);
+    CHECK(!doc.get<unsigned>("neg"_key));
+    CHECK(!doc.get<int>("title"_key));          // wrong type
+    CHECK(!doc.get<int>("missing"_key));
+}
+
+static void test_paths(const ctoml::Doc &doc) {
+    CHECK(doc.get<int>("server.port"_path) == 8080);
+    CHECK(doc.get<int>("server.config.timeout"_path) == 30);
+    CHECK(!doc.get<int>("server.nope.timeout"_path));
+    ctoml::Table cfg = doc.root().table("server.config"_path);
+    CHECK(cfg && cfg.name() == "config");
+    CHECK(!doc.root().table("server.port"_path));
+}
+
+static void test_strings_and_arrays(const ctoml::Doc &doc) {
+    CHECK(doc.get<std::string_view>("title"_key) == std::string_view("wrapper"));
+#if CTOML_HAS_SPAN
+    auto mixed = doc.get<std::span<const double>>("mixed"_key);
+    CHECK(mixed && mixed->size() == 3);
+    if (mixed && mixed->size() == 3)
+        CHECK((*mixed)[0] == 1.5 && (*mixed)[1] == 2.0 && (*mixed)[2] == 3.0);
+    CHECK(!doc.get<std::span<const int64_t>>("mixed"_key));
+#endif
+}
+
+static void test_elements(const ctoml::Doc &doc) {
+    ctoml::Table users = doc.root().table("users"_key);
+    CHECK(users.is_array());
+    CHECK(users.elements().size() == 2);
+    const char *names[] = {"Alice", "Bob"};
+    int ages[] = {30, 25};
+    int i = 0;
+    for (ctoml::Table u : users.elements()) {
+        if (i < 2) {
+            CHECK(u.get<std::string_view>("name"_key) == std::string_view(names[i]));
+            CHECK(u.get<int>("age"_key) == ages[i]);
+        }
+        i++;
+    }
+    CHECK(i == 2);
+    // lookups on the container go to its latest element
+    CHECK(users.get<std::string_view>("name"_key) == std::string_view("Bob"));
+}
+
+static void test_move(ctoml::Doc doc) {
+    ctoml::Doc moved = std::move(doc);
+    CHECK(moved);
+    CHECK(!doc);
+    CHECK(!doc.c_ptr() && !doc.root() && !doc.get<int>("small"_key));
+    CHECK(moved.get<int>("small"_key) == 42);
+
+    ctoml::Doc other;
+    other = std::move(moved);
+    CHECK(other && !moved);
+}
+
+int main() {
+    std::FILE *f = std::fopen("hpp_test_in.toml", "wb");
+    if (!f) return 1;
+    std::fputs(input, f);
+    std::fclose(f);
+
+    ctoml::Doc doc = ctoml::Doc::load("hpp_test_in.toml");
+    CHECK(doc);
+    if (doc) {
+        test_integers(doc);
+        test_paths(doc);
+        test_strings_and_arrays(doc);
+        test_elements(doc);
+        test_move(std::move(doc));
+    }
+    std::remove("hpp_test_in.toml");
+
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    else std::printf("hpp_test: all checks passed\n");
+    return failures ? 1 : 0;
+}
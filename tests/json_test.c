@@ -0,0 +1,170 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "toml.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// toml_to_json() checks: exact JSON for each supported construct, and the
+// error message for input that must be rejected.
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// Runs the converter over text; returns its result and the JSON in *json.
+static int convert(const char *text, char **json, TomlError *err) {
+    FILE *in = tmpfile(), *out = tmpfile();
+    if (!in || !out) { fprintf(stderr, "tmpfile failed\n"); exit(1); }
+    fputs(text, in);
+    rewind(in);
+    int rc = toml_to_json(in, out, err);
+    long n = ftell(out);
+    rewind(out);
+    *json = malloc((size_t)n + 1);
+    (*json)[fread(*json, 1, (size_t)n, out)] = '\0';
+    fclose(in);
+    fclose(out);
+    return rc;
+}
+
+static void expect_json(int line, const char *toml, const char *want) {
+    char *got;
+    TomlError err = {0};
+    int rc = convert(toml, &got, &err);
+    if (rc != 0 || strcmp(got, want)) {
+        fprintf(stderr, "%s:%d: rc=%d (%s)\n got: %s want: %s\n",
+                __FILE__, line, rc, err.message, got, want);
+        failures++;
+    }
+    free(got);
+}
+
+static void expect_error(int line, const char *toml, int err_line, const char *msg) {
+    char *got;
+    TomlError err = {0};
+    int rc = convert(toml, &got, &err);
+    if (rc != -1 || err.line != err_line || strcmp(err.message, msg)) {
+        fprintf(stderr, "%s:%d: rc=%d line=%d \"%s\", want -1 line=%d \"%s\"\n",
+                __FILE__, line, rc, err.line, err.message, err_line, msg);
+        failures++;
+    }
+    free(got);
+}
+
+#define EXPECT_JSON(toml, json) expect_json(__LINE__, toml, json)
+#define EXPECT_ERROR(toml, line, msg) expect_error(__LINE__, toml, line, msg)
+
+static void test_strings(void) {
+    EXPECT_JSON("s = \"tab\\there \\\"q\\\" \\\\ \\e\"\n",
+                "{\"s\":\"tab\\there \\\"q\\\" \\\\ \\u001b\"}\n");
+    EXPECT_JSON("u = \"\\u00e9 \\U0001F600\"\n",
+                "{\"u\":\"\xc3\xa9 \xf0\x9f\x98\x80\"}\n");
+    EXPECT_JSON("path = 'C:\\dir\\n'\n",
+                "{\"path\":\"C:\\\\dir\\\\n\"}\n");
+    EXPECT_JSON("m = \"\"\"\nline 1\nline \"2\"\"\"\"\n",
+                "{\"m\":\"line 1\\nline \\\"2\\\"\"}\n");
+    EXPECT_JSON("m = \"\"\"\r\none \\\r\n    two\"\"\"\r\n",
+                "{\"m\":\"one two\"}\n");
+    EXPECT_JSON("r = '''\nraw \\n ''x'''\n",
+                "{\"r\":\"raw \\\\n ''x\"}\n");
+    EXPECT_JSON("\"quoted key\" = 1\n",
+                "{\"quoted key\":1}\n");
+}
+
+// Lines at the edge of the one-line key/value fast path must convert the
+// same as through the general lexer.
+static void test_simple_lines(void) {
+    EXPECT_JSON("s = \"a#b\"  # c\r\nl = 'x#y'\r\n",
+                "{\"s\":\"a#b\",\"l\":\"x#y\"}\n");
+    EXPECT_JSON("e = \"\"\nt = \"tab\tin\"\nq = 'say \"hi\"'\n",
+                "{\"e\":\"\",\"t\":\"tab\\tin\",\"q\":\"say \\\"hi\\\"\"}\n");
+    EXPECT_JSON("n = 42", "{\"n\":42}\n");
+    EXPECT_JSON("b=true#no space\n", "{\"b\":true}\n");
+    EXPECT_ERROR("a = 1\nb = 2\nc = 1979-13-01\n", 3, "invalid datetime");
+    EXPECT_ERROR("a = 1,\n", 1, "expected end of line");
+}
+
+static void test_arrays(void) {
+    EXPECT_JSON("a = [ [1, 2], # first\n"
+                "  [\"x\", ],\n"
+                "  # between\n"
+                "  [ [] ],\n"
+                "]\n",
+                "{\"a\":[[1,2],[\"x\"],[[]]]}\n");
+    EXPECT_JSON("mixed = [1, 2.5, \"s\", true, { k = 1 }]\n",
+                "{\"mixed\":[1,2.5,\"s\",true,{\"k\":1}]}\n");
+}
+
+static void test_inline_tables(void) {
+    EXPECT_JSON("pt = { x = 1, y.z = 2, y.w = 3 }\n",
+                "{\"pt\":{\"x\":1,\"y\":{\"z\":2,\"w\":3}}}\n");
+    EXPECT_JSON("e = {}\nn = { a = { b = [] } }\n",
+                "{\"e\":{},\"n\":{\"a\":{\"b\":[]}}}\n");
+}
+
+static void test_tables(void) {
+    EXPECT_JSON("top = 0\n"
+                "[[a]]\nn = 1\n"
+                "[a.b]\nv = 2\n"
+                "[[a.c]]\nw = 3\n"
+                "[[a.c]]\nw = 4\n"
+                "[[a]]\nn = 5\n"
+                "[x.y]\ndotted.key = 6\n",
+                "{\"top\":0,"
+                "\"a\":[{\"n\":1,\"b\":{\"v\":2},\"c\":[{\"w\":3},{\"w\":4}]},{\"n\":5}],"
+                "\"x\":{\"y\":{\"dotted\":{\"key\":6}}}}\n");
+}
+
+static void test_scalars(void) {
+    EXPECT_JSON("odt = 1979-05-27T07:32:00Z\n"
+                "sp = 1979-05-27 07:32:00.5-07:00\n"
+                "ld = 2024-02-29\n"
+                "lt = 07:32:00.999\n",
+                "{\"odt\":\"1979-05-27T07:32:00Z\","
+                "\"sp\":\"1979-05-27T07:32:00.5-07:00\","
+                "\"ld\":\"2024-02-29\","
+                "\"lt\":\"07:32:00.999\"}\n");
+    EXPECT_JSON("hex = 0xDEAD_beef\noct = 0o755\nbin = 0b1101\n"
+                "big = 1_000_000\nplus = +5\nneg = -9223372036854775808\n"
+                "f = 6.626e-34\ng = -0.5\n",
+                "{\"hex\":3735928559,\"oct\":493,\"bin\":13,"
+                "\"big\":1000000,\"plus\":5,\"neg\":-9223372036854775808,"
+                "\"f\":6.626e-34,\"g\":-0.5}\n");
+    EXPECT_JSON("a = inf\nb = +inf\nc = -inf\nd = nan\n",
+                "{\"a\":\"inf\",\"b\":\"inf\",\"c\":\"-inf\",\"d\":\"nan\"}\n");
+}
+
+static void test_errors(void) {
+    EXPECT_ERROR("ok = 1\nx = 9223372036854775808\n", 2, "integer out of range");
+    EXPECT_ERROR("x = 0x8000000000000000\n", 1, "integer out of range");
+    EXPECT_ERROR("x = 0o9\n", 1, "invalid integer");
+    EXPECT_ERROR("d = 2023-02-29\n", 1, "invalid datetime");
+    EXPECT_ERROR("t = 24:00:00\n", 1, "invalid datetime");
+    EXPECT_ERROR("s = \"\"\"\nnever closed\n", 3, "unterminated string");
+    EXPECT_ERROR("s = \"abc\n", 1, "newline in string");
+    EXPECT_ERROR("s = \"\\q\"\n", 1, "bad escape sequence");
+    EXPECT_ERROR("a = [1 2]\n", 1, "expected ',' in array");
+    EXPECT_ERROR("a = 1 2\n", 1, "expected end of line");
+
+    // 40 nested arrays, past JSON_MAX_DEPTH
+    char deep[128] = "a = ";
+    for (int i = 0; i < 40; i++) strcat(deep, "[");
+    for (int i = 0; i < 40; i++) strcat(deep, "]");
+    strcat(deep, "\n");
+    EXPECT_ERROR(deep, 1, "value nested too deep");
+}
+
+int main(void) {
+    test_strings();
+    test_simple_lines();
+    test_arrays();
+    test_inline_tables();
+    test_tables();
+    test_scalars();
+    test_errors();
+    if (failures) fprintf(stderr, "%d check(s) failed\n", failures);
+    else printf("json_test: all checks passed\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "toml.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Round-trip checks for toml_set_* + toml_patch_write(): the output must
+// equal the input byte-for-byte except for the edited value spans.
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static void write_file(const char *path, const char *text) {
+    FILE *f = fopen(path, "wb");
+    fputs(text, f);
+    fclose(f);
+}
+
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc((size_t)n + 1);
+    buf[fread(buf, 1, (size_t)n, f)] = '\0';
+    fclose(f);
+    return buf;
+}
+
+// Replaces every "\n" in src with eol.
+static char *with_eol(const char *src, const char *eol) {
+    char *out = malloc(strlen(src) * strlen(eol) + 1), *w = out;
+    for (; *src; src++) {
+        if (*src == '\n') { strcpy(w, eol); w += strlen(eol); }
+        else *w++ = *src;
+    }
+    *w = '\0';
+    return out;
+}
+
+static const char *input =
+    "# top comment\n"
+    "title = \"old\"   # keep me\n"
+    "password = \"abc#123\"  # rotate me\n"
+    "note = \"\"\"one-liner\"\"\"\n"
+    "block = \"\"\"\n"
+    "line 1\n"
+    "\"\"\"\n"
+    "   version = 1.2\n"
+    "\n"
+    "[server]\n"
+    "port    =   8080\n"
+    "details = { os = \"linux\", cores = 8, ipv6 = false }  # inline\n"
+    "\n"
+    "[[users]]\n"
+    "name = \"Alice\"\n";
+
+static const char *expected =
+    "# top comment\n"
+    "title = \"new\"   # keep me\n"
+    "password = \"n3w\"  # rotate me\n"
+    "note = \"changed\"\n"
+    "block = \"\"\"\n"
+    "line 1\n"
+    "\"\"\"\n"
+    "   version = 2.0\n"
+    "\n"
+    "[server]\n"
+    "port    =   9090\n"
+    "details = { os = \"bsd\", cores = 16, ipv6 = false }  # inline\n"
+    "\n"
+    "[[users]]\n"
+    "name = \"Alice\"\n";
+
+static void test_patch(const char *eol) {
+    char *in = with_eol(input, eol), *want = with_eol(expected, eol);
+    write_file("patch_test_in.toml", in);
+
+    TomlDoc *doc = toml_load("patch_test_in.toml");
+    CHECK(doc != NULL);
+    if (!doc) return;
+
+    // nothing edited: output is the input
+    CHECK(toml_patch_write(doc, "patch_test_out.toml") == 0);
+    char *out = read_file("patch_test_out.toml");
+    CHECK(out && !strcmp(out, in));
+    free(out);
+
+    TomlTable *server = toml_table_get(doc->root, "server");
+    CHECK(server != NULL);
+    const TomlEntry *details = server ? toml_entry_get(server, "details") : NULL;
+    CHECK(details && details->type == TOML_TABLE);
+
+    // too long for str_val: refused with the entry left as it was
+    char long_val[MAX_VAL_LEN + 1];
+    memset(long_val, 'x', MAX_VAL_LEN);
+    long_val[MAX_VAL_LEN] = '\0';
+    CHECK(toml_set_string(doc->root, "password", long_val) == -1);
+    const TomlEntry *pw = toml_entry_get(doc->root, "password");
+    CHECK(pw && !pw->dirty && !strcmp(pw->value.str_val, "abc#123"));
+    long_val[MAX_VAL_LEN - 1] = '\0';
+    CHECK(toml_set_string(doc->root, "password", long_val) == 0);
+
+    CHECK(toml_set_string(doc->root, "title", "new") == 0);
+    CHECK(toml_set_string(doc->root, "note", "changed") == 0);
+    CHECK(toml_set_string(doc->root, "password", "n3w") == 0);
+    CHECK(toml_set_float(doc->root, "version", 2.0) == 0);
+    CHECK(toml_set_int(doc->root, "missing", 1) == -1);
+    if (server) CHECK(toml_set_int(server, "port", 9090) == 0);
+    if (details && details->type == TOML_TABLE) {
+        CHECK(toml_set_string(details->value.table_val, "os", "bsd") == 0);
+        CHECK(toml_set_int(details->value.table_val, "cores", 16) == 0);
+    }
+
+    CHECK(toml_patch_write(doc, "patch_test_out.toml") == 0);
+    out = read_file("patch_test_out.toml");
+    CHECK(out && !strcmp(out, want));
+    if (out && strcmp(out, want)) fprintf(stderr, "got:\n%s\nwant:\n%s\n", out, want);
+    free(out);
+
+    toml_free(doc);
+    free(in);
+    free(want);
+}
+
+static void test_unterminated_refused(void) {
+    write_file("patch_test_in.toml", "a = 1\nb = \"\"\"\nnever closed\n");
+    TomlDoc *doc = toml_load("patch_test_in.toml");
+    CHECK(doc && doc->errs.count == 1);
+    if (!doc) return;
+    CHECK(toml_set_string(doc->root, "b", "x") == 0);
+    remove("patch_test_out.toml");
+    CHECK(toml_patch_write(doc, "patch_test_out.toml") == -1);
+    CHECK(read_file("patch_test_out.toml") == NULL);
+    toml_free(doc);
+}
+
+// A '#' after an unclosed quote may be inside the value: no trusted span.
+static void test_open_quote_refused(void) {
+    write_file("patch_test_in.toml", "a = \"abc # not closed\n");
+    TomlDoc *doc = toml_load("patch_test_in.toml");
+    CHECK(doc != NULL);
+    if (!doc) return;
+    CHECK(toml_set_string(doc->root, "a", "x") == 0);
+    remove("patch_test_out.toml");
+    CHECK(toml_patch_write(doc, "patch_test_out.toml") == -1);
+    CHECK(read_file("patch_test_out.toml") == NULL);
+    toml_free(doc);
+}
+
+int main(void) {
+    test_patch("\n");
+    test_patch("\r\n");
+    test_unterminated_refused();
+    test_open_quote_refused();
+    remove("patch_test_in.toml");
+    remove("patch_test_out.toml");
+    if (failures) fprintf(stderr, "%d check(s) failed\n", failures);
+    else printf("patch_test: all checks passed\n");
+    return failures ? 1 : 0;
+}
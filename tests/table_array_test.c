@@ -0,0 +1,70 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "toml.h"
+#include <stdio.h>
+#include <string.h>
+
+// [[name]] elements keep their own keys and sub-headers, and survive a
+// toml_write() round trip.
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static void check_fruits(const char *path) {
+    TomlDoc *doc = toml_load(path);
+    CHECK(doc != NULL);
+    if (!doc) return;
+
+    TomlTable *fruits = toml_table_get(doc->root, "fruits");
+    CHECK(fruits && fruits->is_array && fruits->arr_count == 2);
+    if (fruits && fruits->arr_count == 2) {
+        TomlTable *apple = fruits->table_array[0], *banana = fruits->table_array[1];
+        CHECK(!strcmp(toml_get_string(apple, "name", ""), "apple"));
+        CHECK(!strcmp(toml_get_string(banana, "name", ""), "banana"));
+
+        TomlTable *physical = toml_table_get(apple, "physical");
+        CHECK(physical && !strcmp(toml_get_string(physical, "color", ""), "red"));
+        CHECK(toml_table_get(banana, "physical") == NULL);
+
+        TomlTable *variety = toml_table_get(apple, "variety");
+        CHECK(variety && variety->arr_count == 2);
+        variety = toml_table_get(banana, "variety");
+        CHECK(variety && variety->arr_count == 1);
+
+        // the container resolves to its latest element
+        CHECK(!strcmp(toml_get_string(fruits, "name", ""), "banana"));
+    }
+    toml_free(doc);
+}
+
+int main(void) {
+    FILE *f = fopen("table_array_in.toml", "wb");
+    fputs("[[fruits]]\n"
+          "name = \"apple\"\n"
+          "[fruits.physical]\n"
+          "color = \"red\"\n"
+          "[[fruits.variety]]\n"
+          "name = \"red delicious\"\n"
+          "[[fruits.variety]]\n"
+          "name = \"granny smith\"\n"
+          "[[fruits]]\n"
+          "name = \"banana\"\n"
+          "[[fruits.variety]]\n"
+          "name = \"plantain\"\n", f);
+    fclose(f);
+
+    check_fruits("table_array_in.toml");
+
+    TomlDoc *doc = toml_load("table_array_in.toml");
+    CHECK(doc && toml_write(doc, "table_array_out.toml", NULL) == 0);
+    toml_free(doc);
+    check_fruits("table_array_out.toml");
+
+    remove("table_array_in.toml");
+    remove("table_array_out.toml");
+    if (failures) fprintf(stderr, "%d check(s) failed\n", failures);
+    else printf("table_array_test: all checks passed\n");
+    return failures ? 1 : 0;
+}